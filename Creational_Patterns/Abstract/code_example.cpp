@@ -270,3 +270,441 @@ Main: Chicken Main Course, Side: Fries Side, Drink: Soda
 Main: Noodles Main Course, Side: SpringRolls Side, Drink: Iced Tea
 */
 // Client code never mixes families, and new meal types can be added by extending factories only.
+
+// ===== Flyweight Variant: Shared Meal Components =====
+// Products carry no state besides their type, so every factory can hand out
+// the same immutable instance instead of allocating a new one per meal.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+using namespace std;
+
+// Abstract products (immutable: only const members)
+class MainCourse
+{
+public:
+    virtual string name() const = 0;
+    virtual ~MainCourse() = default;
+};
+class Side
+{
+public:
+    virtual string name() const = 0;
+    virtual ~Side() = default;
+};
+class Drink
+{
+public:
+    virtual string name() const = 0;
+    virtual ~Drink() = default;
+};
+
+// Concrete Veg Products
+class Paneer : public MainCourse
+{
+public:
+    string name() const override { return "Paneer Main Course"; }
+};
+class Salad : public Side
+{
+public:
+    string name() const override { return "Salad Side"; }
+};
+class Juice : public Drink
+{
+public:
+    string name() const override { return "Juice"; }
+};
+
+// Concrete Non-Veg Products
+class Chicken : public MainCourse
+{
+public:
+    string name() const override { return "Chicken Main Course"; }
+};
+class Fries : public Side
+{
+public:
+    string name() const override { return "Fries Side"; }
+};
+class Soda : public Drink
+{
+public:
+    string name() const override { return "Soda"; }
+};
+
+// Shared (flyweight) instances: allocated once, never freed, never mutated.
+// Returning plain const references means no ownership and no refcounting.
+const Paneer &sharedPaneer()
+{
+    static const Paneer instance;
+    return instance;
+}
+const Salad &sharedSalad()
+{
+    static const Salad instance;
+    return instance;
+}
+const Juice &sharedJuice()
+{
+    static const Juice instance;
+    return instance;
+}
+const Chicken &sharedChicken()
+{
+    static const Chicken instance;
+    return instance;
+}
+const Fries &sharedFries()
+{
+    static const Fries instance;
+    return instance;
+}
+const Soda &sharedSoda()
+{
+    static const Soda instance;
+    return instance;
+}
+
+// Abstract Factory: owning creation plus a flyweight mode
+class MealFactory
+{
+public:
+    virtual unique_ptr<MainCourse> createMainCourse() const = 0;
+    virtual unique_ptr<Side> createSide() const = 0;
+    virtual unique_ptr<Drink> createDrink() const = 0;
+
+    virtual const MainCourse &sharedMainCourse() const = 0;
+    virtual const Side &sharedSide() const = 0;
+    virtual const Drink &sharedDrink() const = 0;
+    virtual ~MealFactory() = default;
+};
+
+// Concrete Factories
+class VegMealFactory : public MealFactory
+{
+public:
+    unique_ptr<MainCourse> createMainCourse() const override { return make_unique<Paneer>(); }
+    unique_ptr<Side> createSide() const override { return make_unique<Salad>(); }
+    unique_ptr<Drink> createDrink() const override { return make_unique<Juice>(); }
+
+    const MainCourse &sharedMainCourse() const override { return sharedPaneer(); }
+    const Side &sharedSide() const override { return sharedSalad(); }
+    const Drink &sharedDrink() const override { return sharedJuice(); }
+};
+
+class NonVegMealFactory : public MealFactory
+{
+public:
+    unique_ptr<MainCourse> createMainCourse() const override { return make_unique<Chicken>(); }
+    unique_ptr<Side> createSide() const override { return make_unique<Fries>(); }
+    unique_ptr<Drink> createDrink() const override { return make_unique<Soda>(); }
+
+    const MainCourse &sharedMainCourse() const override { return sharedChicken(); }
+    const Side &sharedSide() const override { return sharedFries(); }
+    const Drink &sharedDrink() const override { return sharedSoda(); }
+};
+
+// An owning meal: three heap allocations per meal
+struct OwnedMeal
+{
+    unique_ptr<MainCourse> mainC;
+    unique_ptr<Side> side;
+    unique_ptr<Drink> drink;
+};
+
+// A flyweight meal: three pointers into the shared instances, no allocations
+struct SharedMeal
+{
+    const MainCourse *mainC;
+    const Side *side;
+    const Drink *drink;
+};
+
+OwnedMeal assembleOwnedMeal(const MealFactory &factory)
+{
+    return {factory.createMainCourse(), factory.createSide(), factory.createDrink()};
+}
+
+SharedMeal assembleSharedMeal(const MealFactory &factory)
+{
+    return {&factory.sharedMainCourse(), &factory.sharedSide(), &factory.sharedDrink()};
+}
+
+// Bytes currently allocated on the heap, including allocator chunk overhead.
+// Returns 0 where the C library offers no heap statistics.
+size_t liveHeapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd; // small-chunk heap + mmap-ed blocks
+#else
+    return 0;
+#endif
+}
+
+// Keeps `count` meals alive at once and reports the heap they occupy and the
+// time to build them.
+template <typename Meal, typename Assemble>
+void measure(const string &label, size_t count, Assemble assemble)
+{
+    VegMealFactory vegFactory;
+    NonVegMealFactory nonVegFactory;
+
+    size_t heapBefore = liveHeapBytes();
+    auto start = chrono::steady_clock::now();
+    vector<Meal> meals;
+    meals.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i % 2 == 0)
+            meals.push_back(assemble(vegFactory));
+        else
+            meals.push_back(assemble(nonVegFactory));
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    size_t heapAfter = liveHeapBytes();
+    cout << label << ": " << meals.size() << " live meals, ";
+    if (heapAfter)
+        cout << (heapAfter - heapBefore) / (1024 * 1024) << " MiB live heap";
+    else // no heap statistics: fall back to object sizes, which miss allocator overhead
+        cout << "~" << (meals.size() * (sizeof(Meal) + (is_same_v<Meal, OwnedMeal> ? 3 * sizeof(Paneer) : 0))) / (1024 * 1024)
+             << " MiB by sizeof";
+    cout << ", built in " << elapsed.count() << " ms\n";
+}
+
+int main()
+{
+    VegMealFactory vegFactory;
+    SharedMeal a = assembleSharedMeal(vegFactory);
+    SharedMeal b = assembleSharedMeal(vegFactory);
+    cout << "Main: " << a.mainC->name() << ", Side: " << a.side->name()
+         << ", Drink: " << a.drink->name() << "\n";
+    cout << "Same Paneer instance: " << (a.mainC == b.mainC ? "yes" : "no") << "\n";
+
+    const size_t kMeals = 10'000'000;
+    measure<OwnedMeal>("unique_ptr", kMeals, assembleOwnedMeal);
+    measure<SharedMeal>("flyweight ", kMeals, assembleSharedMeal);
+    return 0;
+}
+
+/*
+Output (timings vary by machine):
+Main: Paneer Main Course, Side: Salad Side, Drink: Juice
+Same Paneer instance: yes
+unique_ptr: 10000000 live meals, 1144 MiB live heap, built in 1770 ms
+flyweight : 10000000 live meals, 228 MiB live heap, built in 360 ms
+*/
+// Every meal of a family points at the same three objects; the only per-meal cost is the handle itself.
+// (Each 8-byte product costs a 32-byte heap chunk, which is why the owning path is 5x larger, not 2x.)
+
+// ===== Binary Serialization of Assembled Meals =====
+// Because a factory never mixes families, one family byte fully describes a meal.
+// Layout: 'M' 'L' version(u8) count(u32 little-endian), then one family byte per meal.
+// Assembled meals are printed through the Singleton example's shared OutputSink.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <singleton/singleton_use_case_asynchronous_output_sink.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+using singleton::singleton_use_case_asynchronous_output_sink::OutputSink;
+
+// Abstract products
+class MainCourse
+{
+public:
+    virtual string name() const = 0;
+    virtual ~MainCourse() = default;
+};
+class Side
+{
+public:
+    virtual string name() const = 0;
+    virtual ~Side() = default;
+};
+class Drink
+{
+public:
+    virtual string name() const = 0;
+    virtual ~Drink() = default;
+};
+
+// Concrete Veg Products
+class Paneer : public MainCourse
+{
+public:
+    string name() const override { return "Paneer Main Course"; }
+};
+class Salad : public Side
+{
+public:
+    string name() const override { return "Salad Side"; }
+};
+class Juice : public Drink
+{
+public:
+    string name() const override { return "Juice"; }
+};
+
+// Concrete Non-Veg Products
+class Chicken : public MainCourse
+{
+public:
+    string name() const override { return "Chicken Main Course"; }
+};
+class Fries : public Side
+{
+public:
+    string name() const override { return "Fries Side"; }
+};
+class Soda : public Drink
+{
+public:
+    string name() const override { return "Soda"; }
+};
+
+enum class MealFamily : uint8_t
+{
+    Veg = 1,
+    NonVeg = 2
+};
+
+// Abstract Factory (knows which family it produces)
+class MealFactory
+{
+public:
+    virtual MealFamily family() const = 0;
+    virtual unique_ptr<MainCourse> createMainCourse() const = 0;
+    virtual unique_ptr<Side> createSide() const = 0;
+    virtual unique_ptr<Drink> createDrink() const = 0;
+    virtual ~MealFactory() = default;
+};
+
+// Concrete Factories
+class VegMealFactory : public MealFactory
+{
+public:
+    MealFamily family() const override { return MealFamily::Veg; }
+    unique_ptr<MainCourse> createMainCourse() const override { return make_unique<Paneer>(); }
+    unique_ptr<Side> createSide() const override { return make_unique<Salad>(); }
+    unique_ptr<Drink> createDrink() const override { return make_unique<Juice>(); }
+};
+
+class NonVegMealFactory : public MealFactory
+{
+public:
+    MealFamily family() const override { return MealFamily::NonVeg; }
+    unique_ptr<MainCourse> createMainCourse() const override { return make_unique<Chicken>(); }
+    unique_ptr<Side> createSide() const override { return make_unique<Fries>(); }
+    unique_ptr<Drink> createDrink() const override { return make_unique<Soda>(); }
+};
+
+// An assembled meal remembers the family it came from
+struct Meal
+{
+    MealFamily family;
+    unique_ptr<MainCourse> mainC;
+    unique_ptr<Side> side;
+    unique_ptr<Drink> drink;
+};
+
+Meal assembleMeal(const MealFactory &factory)
+{
+    return {factory.family(), factory.createMainCourse(), factory.createSide(), factory.createDrink()};
+}
+
+const MealFactory &factoryFor(MealFamily family)
+{
+    static const VegMealFactory veg;
+    static const NonVegMealFactory nonVeg;
+    switch (family)
+    {
+    case MealFamily::Veg:
+        return veg;
+    case MealFamily::NonVeg:
+        return nonVeg;
+    }
+    throw runtime_error("unknown meal family");
+}
+
+const uint8_t kMealFormatVersion = 1;
+
+string encodeMeals(const vector<Meal> &meals)
+{
+    string out;
+    out.reserve(7 + meals.size());
+    out += 'M';
+    out += 'L';
+    out.push_back(char(kMealFormatVersion));
+    uint32_t count = static_cast<uint32_t>(meals.size());
+    for (int i = 0; i < 4; ++i)
+        out.push_back(char((count >> (8 * i)) & 0xFF));
+    for (const auto &meal : meals)
+        out.push_back(char(meal.family));
+    return out;
+}
+
+// Zero-copy view: the family codes stay in the caller's buffer
+string_view mealFamiliesView(string_view in)
+{
+    if (in.size() < 7 || in[0] != 'M' || in[1] != 'L')
+        throw runtime_error("not a meal buffer");
+    if (uint8_t(in[2]) != kMealFormatVersion)
+        throw runtime_error("unsupported meal format version");
+    uint32_t count = 0;
+    for (int i = 0; i < 4; ++i)
+        count |= uint32_t(uint8_t(in[3 + i])) << (8 * i);
+    if (in.size() - 7 < count)
+        throw runtime_error("truncated meal buffer");
+    return in.substr(7, count);
+}
+
+vector<Meal> decodeMeals(string_view in)
+{
+    vector<Meal> meals;
+    for (char code : mealFamiliesView(in))
+        meals.push_back(assembleMeal(factoryFor(MealFamily(uint8_t(code)))));
+    return meals;
+}
+
+int main()
+{
+    vector<Meal> meals;
+    meals.push_back(assembleMeal(VegMealFactory()));
+    meals.push_back(assembleMeal(NonVegMealFactory()));
+
+    string bytes = encodeMeals(meals);
+    vector<Meal> decoded = decodeMeals(bytes);
+    assert(decoded.size() == meals.size());
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        assert(decoded[i].mainC->name() == meals[i].mainC->name());
+        OutputSink::getInstance().write("Main: ", decoded[i].mainC->name() + ", Side: " + decoded[i].side->name() +
+                                                      ", Drink: " + decoded[i].drink->name());
+    }
+    OutputSink::getInstance().flush(); // keep the meals ahead of the summary
+    cout << "Encoded " << meals.size() << " meals in " << bytes.size() << " bytes\n";
+    return 0;
+}
+
+/*
+Output:
+Main: Paneer Main Course, Side: Salad Side, Drink: Juice
+Main: Chicken Main Course, Side: Fries Side, Drink: Soda
+Encoded 2 meals in 9 bytes
+*/
+// The family guarantee of Abstract Factory is what keeps the encoding this small.
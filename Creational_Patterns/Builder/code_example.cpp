@@ -104,3 +104,547 @@ Sandwich: Wheat, Paneer, Mint, Extras: Lettuce,Olives
 Sandwich: White, Cheese, Mayo, Extras: 
 */
 // Client code is clear and flexible, even for many options or different sandwich types.
+
+
+// ===== Streaming Ingestion Into the Builder =====
+// Orders arrive as a newline-delimited file: bread|filling|sauce|extras
+// A reader thread loads the file in large chunks and splits it into string_view
+// fields; the main thread feeds those views straight into the builder.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class Sandwich {
+    string bread, filling, sauce, extras;
+public:
+    Sandwich(string_view bread, string_view filling, string_view sauce, string_view extras)
+        : bread(bread), filling(filling), sauce(sauce), extras(extras) {}
+
+    void describe() const {
+        cout << "Sandwich: " << bread << ", " << filling << ", " << sauce
+             << ", Extras: " << extras << "\n";
+    }
+};
+
+// Builder Interface (takes views, so callers never build temporary strings)
+class SandwichBuilder {
+protected:
+    string bread, filling, sauce, extras;
+public:
+    virtual SandwichBuilder& addBread(string_view b) = 0;
+    virtual SandwichBuilder& addFilling(string_view f) = 0;
+    virtual SandwichBuilder& addSauce(string_view s) = 0;
+    virtual SandwichBuilder& addExtras(string_view e) = 0;
+    virtual unique_ptr<Sandwich> build() = 0;
+    virtual ~SandwichBuilder() = default;
+};
+
+// Concrete Builder (assign() reuses the member strings' capacity between orders)
+class VegSandwichBuilder : public SandwichBuilder {
+public:
+    SandwichBuilder& addBread(string_view b) override { bread.assign(b); return *this; }
+    SandwichBuilder& addFilling(string_view f) override { filling.assign(f); return *this; }
+    SandwichBuilder& addSauce(string_view s) override { sauce.assign(s); return *this; }
+    SandwichBuilder& addExtras(string_view e) override { extras.assign(e); return *this; }
+    unique_ptr<Sandwich> build() override {
+        return make_unique<Sandwich>(bread, filling, sauce, extras);
+    }
+};
+
+// One parsed order: views into the chunk buffer that owns the bytes
+struct SandwichOrder {
+    string_view bread, filling, sauce, extras;
+};
+
+// A chunk of whole lines plus the orders parsed out of it
+struct OrderBatch {
+    string buffer;
+    vector<SandwichOrder> orders;
+    size_t malformed = 0;  // lines without exactly four fields
+};
+
+// Splits complete lines into fields. memchr is vectorized by the C library,
+// so the delimiter scan runs over 16-64 bytes per step on common platforms.
+void parseOrders(OrderBatch& batch) {
+    const char* p = batch.buffer.data();
+    const char* end = p + batch.buffer.size();
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        string_view fields[4];
+        int n = 0;
+        const char* field = p;
+        while (n < 3) {
+            const char* bar = static_cast<const char*>(memchr(field, '|', eol - field));
+            if (!bar)
+                break;
+            fields[n++] = string_view(field, bar - field);
+            field = bar + 1;
+        }
+        fields[n++] = string_view(field, eol - field);
+        bool extraField = memchr(field, '|', eol - field) != nullptr;
+        if (n == 4 && !extraField)
+            batch.orders.push_back({fields[0], fields[1], fields[2], fields[3]});
+        else if (eol > p)  // blank lines are not orders, but not errors either
+            ++batch.malformed;
+        if (eol == end)  // last line had no newline
+            break;
+        p = eol + 1;
+    }
+}
+
+// Bounded hand-off between the reader thread and the builder thread
+class BatchQueue {
+    queue<unique_ptr<OrderBatch>> batches;
+    mutex m;
+    condition_variable notFull, notEmpty;
+    size_t capacity;
+    bool closed = false;
+public:
+    explicit BatchQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(unique_ptr<OrderBatch> batch) {
+        unique_lock<mutex> lock(m);
+        notFull.wait(lock, [&] { return batches.size() < capacity; });
+        batches.push(move(batch));
+        notEmpty.notify_one();
+    }
+    void close() {
+        lock_guard<mutex> lock(m);
+        closed = true;
+        notEmpty.notify_all();
+    }
+    unique_ptr<OrderBatch> pop() {  // nullptr once closed and drained
+        unique_lock<mutex> lock(m);
+        notEmpty.wait(lock, [&] { return !batches.empty() || closed; });
+        if (batches.empty())
+            return nullptr;
+        auto batch = move(batches.front());
+        batches.pop();
+        notFull.notify_one();
+        return batch;
+    }
+};
+
+// Reads the file in fixed-size chunks; a line cut by the chunk boundary is
+// carried over to the front of the next chunk.
+void readOrders(const string& path, BatchQueue& out, size_t chunkSize = 1 << 20) {
+    ifstream in(path, ios::binary);
+    string carry;
+    while (in) {
+        auto batch = make_unique<OrderBatch>();
+        batch->buffer.swap(carry);
+        size_t kept = batch->buffer.size();
+        batch->buffer.resize(kept + chunkSize);
+        in.read(&batch->buffer[kept], chunkSize);
+        batch->buffer.resize(kept + in.gcount());
+
+        if (in) {
+            size_t lastNewline = batch->buffer.rfind('\n');
+            if (lastNewline == string::npos) {  // line longer than a chunk: keep reading
+                carry.swap(batch->buffer);
+                continue;
+            }
+            carry.assign(batch->buffer, lastNewline + 1, string::npos);
+            batch->buffer.resize(lastNewline + 1);
+        }
+        parseOrders(*batch);
+        out.push(move(batch));
+    }
+    out.close();
+}
+
+bool writeSampleOrders(const string& path, size_t count) {
+    const char* lines[] = {"Wheat|Paneer|Mint|Lettuce,Olives\n",
+                           "White|Cheese|Mayo|\n",
+                           "Multigrain|Tofu|Chipotle|Onion,Jalapeno,Tomato\n"};
+    ofstream out(path, ios::binary);
+    for (size_t i = 0; i < count && out; ++i)
+        out << lines[i % 3];
+    out << "Rye|Egg\n";  // one malformed line, to show it is reported
+    return bool(out);
+}
+
+// Client code
+int main() {
+    const string path = "sandwich_orders.txt";
+    const size_t kOrders = 5'000'000;
+    if (!writeSampleOrders(path, kOrders)) {
+        cerr << "Cannot write " << path << " in the working directory\n";
+        return 1;
+    }
+
+    BatchQueue queue(8);
+    auto start = chrono::steady_clock::now();
+    thread reader(readOrders, cref(path), ref(queue), size_t(1) << 20);
+
+    VegSandwichBuilder builder;
+    size_t built = 0, bytes = 0, malformed = 0;
+    unique_ptr<Sandwich> last;
+    while (auto batch = queue.pop()) {
+        bytes += batch->buffer.size();
+        malformed += batch->malformed;
+        for (const auto& order : batch->orders) {
+            last = builder.addBread(order.bread)
+                          .addFilling(order.filling)
+                          .addSauce(order.sauce)
+                          .addExtras(order.extras)
+                          .build();
+            ++built;
+        }
+    }
+    reader.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    remove(path.c_str());
+    if (!last) {
+        cerr << "No orders could be read from " << path << "\n";
+        return 1;
+    }
+
+    last->describe();
+    cout << "Built " << built << " sandwiches from " << bytes / (1024 * 1024) << " MiB, skipped "
+         << malformed << " malformed line(s)\n";
+    cout << "Throughput: " << bytes / seconds / 1e9 << " GB/s, "
+         << static_cast<size_t>(built / seconds) << " sandwiches/sec\n";
+    return 0;
+}
+
+/*
+Output (throughput varies by machine):
+Sandwich: White, Cheese, Mayo, Extras: 
+Built 5000000 sandwiches from 157 MiB, skipped 1 malformed line(s)
+Throughput: 0.28 GB/s, 8400000 sandwiches/sec
+*/
+// Parsing overlaps with building, and no std::string is created per field until the builder copies it.
+
+
+// ===== Binary Serialization of Built Sandwiches =====
+// A compact, versioned encoding so sandwiches can go to files and queues.
+// Orders reuse a small menu of ingredients, so each distinct string is stored
+// once per batch and records carry only indices into that dictionary.
+// Layout (little-endian, varints are LEB128):
+//   header     : 'S' 'W' version(u8) count(u32)
+//   dictionary : entries(varint), entries x [length(varint) bytes...]
+//   record     : 4 x index(varint)   bread, filling, sauce, extras
+// Readers get SandwichView objects whose fields point into the buffer (zero-copy).
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+class Sandwich {
+    string bread, filling, sauce, extras;
+public:
+    Sandwich(string_view bread, string_view filling, string_view sauce, string_view extras)
+        : bread(bread), filling(filling), sauce(sauce), extras(extras) {}
+
+    const string& getBread() const { return bread; }
+    const string& getFilling() const { return filling; }
+    const string& getSauce() const { return sauce; }
+    const string& getExtras() const { return extras; }
+
+    void describe() const {
+        cout << "Sandwich: " << bread << ", " << filling << ", " << sauce
+             << ", Extras: " << extras << "\n";
+    }
+};
+
+// Builder Interface
+class SandwichBuilder {
+protected:
+    string bread, filling, sauce, extras;
+public:
+    virtual SandwichBuilder& addBread(string_view b) = 0;
+    virtual SandwichBuilder& addFilling(string_view f) = 0;
+    virtual SandwichBuilder& addSauce(string_view s) = 0;
+    virtual SandwichBuilder& addExtras(string_view e) = 0;
+    virtual unique_ptr<Sandwich> build() = 0;
+    virtual ~SandwichBuilder() = default;
+};
+
+// Concrete Builder
+class VegSandwichBuilder : public SandwichBuilder {
+public:
+    SandwichBuilder& addBread(string_view b) override { bread.assign(b); return *this; }
+    SandwichBuilder& addFilling(string_view f) override { filling.assign(f); return *this; }
+    SandwichBuilder& addSauce(string_view s) override { sauce.assign(s); return *this; }
+    SandwichBuilder& addExtras(string_view e) override { extras.assign(e); return *this; }
+    unique_ptr<Sandwich> build() override {
+        return make_unique<Sandwich>(bread, filling, sauce, extras);
+    }
+};
+
+// Read-only view of one encoded sandwich; valid as long as the buffer is
+struct SandwichView {
+    string_view bread, filling, sauce, extras;
+};
+
+const uint8_t kSandwichFormatVersion = 2;
+
+class SandwichEncoder {
+    string out;
+
+    void putVarint(uint64_t v) {  // 7 bits per byte, so small numbers cost one byte
+        while (v >= 0x80) {
+            out.push_back(char((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(char(v));
+    }
+public:
+    // Encodes a whole batch behind a single header. Every distinct ingredient
+    // string is stored once; records refer to it by index.
+    string encode(const vector<unique_ptr<Sandwich>>& sandwiches) {
+        if (sandwiches.size() > UINT32_MAX)
+            throw length_error("more than 2^32-1 sandwiches in one batch");
+
+        unordered_map<string_view, uint32_t> ids;
+        vector<string_view> dictionary;
+        vector<uint32_t> fields;
+        fields.reserve(4 * sandwiches.size());
+        auto intern = [&](const string& s) {
+            auto [it, added] = ids.emplace(s, uint32_t(dictionary.size()));
+            if (added)
+                dictionary.push_back(s);
+            fields.push_back(it->second);
+        };
+        for (const auto& s : sandwiches) {
+            intern(s->getBread());
+            intern(s->getFilling());
+            intern(s->getSauce());
+            intern(s->getExtras());
+        }
+
+        out.clear();
+        out.reserve(7 + 5 + fields.size() + 8 * dictionary.size());
+        uint32_t count = static_cast<uint32_t>(sandwiches.size());
+        out += 'S';
+        out += 'W';
+        out.push_back(char(kSandwichFormatVersion));
+        for (int i = 0; i < 4; ++i)
+            out.push_back(char((count >> (8 * i)) & 0xFF));
+        putVarint(dictionary.size());
+        for (string_view entry : dictionary) {
+            putVarint(entry.size());
+            out.append(entry);
+        }
+        for (uint32_t id : fields)
+            putVarint(id);
+        return move(out);
+    }
+};
+
+class SandwichDecoder {
+    string_view in;
+    size_t pos = 0;
+
+    void need(size_t n) const {
+        if (in.size() - pos < n)
+            throw runtime_error("truncated sandwich buffer");
+    }
+    uint64_t getVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            need(1);
+            uint8_t byte = uint8_t(in[pos++]);
+            if (shift == 63 && byte > 1)  // only one bit left: anything more is overlong
+                break;
+            v |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return v;
+        }
+        throw runtime_error("overlong varint in sandwich buffer");
+    }
+    string_view getString() {
+        uint64_t len = getVarint();
+        need(len);
+        string_view s = in.substr(pos, len);
+        pos += len;
+        return s;
+    }
+public:
+    explicit SandwichDecoder(string_view buffer) : in(buffer) {}
+
+    // Decodes every record as views into the buffer; no strings are copied
+    vector<SandwichView> decodeViews() {
+        pos = 0;
+        need(7);
+        if (in[0] != 'S' || in[1] != 'W')
+            throw runtime_error("not a sandwich buffer");
+        if (uint8_t(in[2]) != kSandwichFormatVersion)
+            throw runtime_error("unsupported sandwich format version");
+        uint32_t count = 0;
+        for (int i = 0; i < 4; ++i)
+            count |= uint32_t(uint8_t(in[3 + i])) << (8 * i);
+        pos = 7;
+
+        // Sizes are untrusted input: never reserve more than the buffer could hold
+        uint64_t entries = getVarint();
+        vector<string_view> dictionary;
+        dictionary.reserve(min<uint64_t>(entries, in.size() - pos));
+        for (uint64_t i = 0; i < entries; ++i)
+            dictionary.push_back(getString());
+        auto field = [&] {
+            uint64_t id = getVarint();
+            if (id >= dictionary.size())
+                throw runtime_error("sandwich field refers to a missing ingredient");
+            return dictionary[id];
+        };
+
+        vector<SandwichView> views;
+        views.reserve(min<size_t>(count, (in.size() - pos) / 4));
+        for (uint32_t i = 0; i < count; ++i) {
+            SandwichView v;
+            v.bread = field();
+            v.filling = field();
+            v.sauce = field();
+            v.extras = field();
+            views.push_back(v);
+        }
+        return views;
+    }
+
+    // Materializes owning sandwiches through the builder
+    vector<unique_ptr<Sandwich>> decode(SandwichBuilder& builder) {
+        vector<unique_ptr<Sandwich>> sandwiches;
+        for (const auto& v : decodeViews())
+            sandwiches.push_back(builder.addBread(v.bread)
+                                        .addFilling(v.filling)
+                                        .addSauce(v.sauce)
+                                        .addExtras(v.extras)
+                                        .build());
+        return sandwiches;
+    }
+};
+
+// Text baseline: the same fields as one "a|b|c|d" line per sandwich
+string encodeText(const vector<unique_ptr<Sandwich>>& sandwiches) {
+    ostringstream out;
+    for (const auto& s : sandwiches)
+        out << s->getBread() << '|' << s->getFilling() << '|' << s->getSauce() << '|'
+            << s->getExtras() << '\n';
+    return out.str();
+}
+
+vector<SandwichView> decodeText(string_view text) {
+    vector<SandwichView> views;
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        string_view line = text.substr(0, eol);
+        string_view f[4];
+        for (int i = 0; i < 3; ++i) {
+            size_t bar = line.find('|');
+            f[i] = line.substr(0, bar);
+            line.remove_prefix(bar + 1);
+        }
+        f[3] = line;
+        views.push_back({f[0], f[1], f[2], f[3]});
+        text.remove_prefix(eol == string_view::npos ? text.size() : eol + 1);
+    }
+    return views;
+}
+
+template <typename F>
+double secondsFor(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Client code
+int main() {
+    VegSandwichBuilder builder;
+    vector<unique_ptr<Sandwich>> sandwiches;
+    sandwiches.push_back(builder.addBread("Wheat").addFilling("Paneer").addSauce("Mint")
+                                .addExtras("Lettuce,Olives").build());
+    sandwiches.push_back(builder.addBread("White").addFilling("Cheese").addSauce("Mayo")
+                                .addExtras("").build());
+
+    // Round trip
+    SandwichEncoder encoder;
+    string bytes = encoder.encode(sandwiches);
+    auto decoded = SandwichDecoder(bytes).decode(builder);
+    assert(decoded.size() == sandwiches.size());
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        assert(decoded[i]->getBread() == sandwiches[i]->getBread());
+        assert(decoded[i]->getFilling() == sandwiches[i]->getFilling());
+        assert(decoded[i]->getSauce() == sandwiches[i]->getSauce());
+        assert(decoded[i]->getExtras() == sandwiches[i]->getExtras());
+        decoded[i]->describe();
+    }
+
+    // Corrupt input is rejected, not read past the end
+    bool rejected = false;
+    try { SandwichDecoder(string_view(bytes).substr(0, bytes.size() - 3)).decodeViews(); }
+    catch (const runtime_error&) { rejected = true; }
+    assert(rejected);
+
+    // So is a varint that does not fit in 64 bits (here: the dictionary size)
+    string overlong = bytes.substr(0, 7) + string(9, char(0xFF)) + char(0x02);
+    rejected = false;
+    try { SandwichDecoder(overlong).decodeViews(); }
+    catch (const runtime_error&) { rejected = true; }
+    assert(rejected);
+
+    // And an index past the end of the dictionary
+    string badIndex = bytes;
+    badIndex.back() = char(0x7F);
+    rejected = false;
+    try { SandwichDecoder(badIndex).decodeViews(); }
+    catch (const runtime_error&) { rejected = true; }
+    assert(rejected);
+
+    // Throughput and size against the text baseline
+    const size_t kSandwiches = 1'000'000;
+    vector<unique_ptr<Sandwich>> batch;
+    for (size_t i = 0; i < kSandwiches; ++i)
+        batch.push_back(builder.addBread(i % 2 ? "White" : "Wheat").addFilling("Paneer")
+                               .addSauce("Mint").addExtras("Lettuce,Olives").build());
+
+    string binary, text;
+    size_t binaryCount = 0, textCount = 0;
+    double binEnc = secondsFor([&] { binary = encoder.encode(batch); });
+    double binDec = secondsFor([&] { binaryCount = SandwichDecoder(binary).decodeViews().size(); });
+    double txtEnc = secondsFor([&] { text = encodeText(batch); });
+    double txtDec = secondsFor([&] { textCount = decodeText(text).size(); });
+    assert(binaryCount == kSandwiches && textCount == kSandwiches);
+
+    cout << "binary: " << binary.size() << " bytes, encode " << size_t(kSandwiches / binEnc)
+         << "/s, decode " << size_t(kSandwiches / binDec) << "/s\n";
+    cout << "text  : " << text.size() << " bytes, encode " << size_t(kSandwiches / txtEnc)
+         << "/s, decode " << size_t(kSandwiches / txtDec) << "/s\n";
+    return 0;
+}
+
+/*
+Output (rates vary by machine):
+Sandwich: Wheat, Paneer, Mint, Extras: Lettuce,Olives
+Sandwich: White, Cheese, Mayo, Extras: 
+binary: 4000047 bytes, encode 9700000/s, decode 24000000/s
+text  : 33000000 bytes, encode 7300000/s, decode 14000000/s
+*/
+// Interning the ingredients makes the binary form about 8x smaller than text; it is also versioned, bounds-checked, and decodes without copying.
@@ -166,3 +166,181 @@ Dine-In Order: Table will be reserved for you at the restaurant.
 "Scheduled Order : The Order is scheduled for later"
 */
 // New order types can be added with new Creator/Product subclasses without modifying client code.
+
+// ===== Binary Serialization of Orders =====
+// Each product reports a stable type code; decoding looks the code up in a
+// table of creators, so the Factory Method still decides which class to build.
+// Layout: 'O' 'R' version(u8) count(u32 little-endian), then one type byte per order.
+// Descriptions go through the Singleton example's shared OutputSink.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <singleton/singleton_use_case_asynchronous_output_sink.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using singleton::singleton_use_case_asynchronous_output_sink::OutputSink;
+
+enum class OrderType : std::uint8_t
+{
+    Delivery = 1,
+    DineIn = 2,
+    Scheduled = 3
+};
+
+// Product
+class Order
+{
+public:
+    virtual void describe() const = 0;
+    virtual OrderType type() const = 0;
+    virtual ~Order() = default;
+};
+
+// Concrete Products
+class DeliveryOrder : public Order
+{
+public:
+    void describe() const override
+    {
+        OutputSink::getInstance().write("Delivery Order: Food will be delivered to your address.");
+    }
+    OrderType type() const override { return OrderType::Delivery; }
+};
+
+class DineInOrder : public Order
+{
+public:
+    void describe() const override
+    {
+        OutputSink::getInstance().write("Dine-In Order: Table will be reserved for you at the restaurant.");
+    }
+    OrderType type() const override { return OrderType::DineIn; }
+};
+
+class ScheduledOrder : public Order
+{
+public:
+    void describe() const override
+    {
+        OutputSink::getInstance().write("Scheduled Order: The order is scheduled for later.");
+    }
+    OrderType type() const override { return OrderType::Scheduled; }
+};
+
+// Creator
+class OrderCreator
+{
+public:
+    virtual std::unique_ptr<Order> createOrder() const = 0;
+    virtual ~OrderCreator() = default;
+};
+
+// Concrete Creators
+class DeliveryOrderCreator : public OrderCreator
+{
+public:
+    std::unique_ptr<Order> createOrder() const override { return std::make_unique<DeliveryOrder>(); }
+};
+
+class DineInOrderCreator : public OrderCreator
+{
+public:
+    std::unique_ptr<Order> createOrder() const override { return std::make_unique<DineInOrder>(); }
+};
+
+class ScheduledOrderCreator : public OrderCreator
+{
+public:
+    std::unique_ptr<Order> createOrder() const override { return std::make_unique<ScheduledOrder>(); }
+};
+
+const std::uint8_t kOrderFormatVersion = 1;
+
+std::string encodeOrders(const std::vector<std::unique_ptr<Order>> &orders)
+{
+    std::string out;
+    out.reserve(7 + orders.size());
+    out += 'O';
+    out += 'R';
+    out.push_back(char(kOrderFormatVersion));
+    std::uint32_t count = static_cast<std::uint32_t>(orders.size());
+    for (int i = 0; i < 4; ++i)
+        out.push_back(char((count >> (8 * i)) & 0xFF));
+    for (const auto &order : orders)
+        out.push_back(char(order->type()));
+    return out;
+}
+
+// Zero-copy view: the type codes stay in the caller's buffer
+std::string_view orderTypesView(std::string_view in)
+{
+    if (in.size() < 7 || in[0] != 'O' || in[1] != 'R')
+        throw std::runtime_error("not an order buffer");
+    if (std::uint8_t(in[2]) != kOrderFormatVersion)
+        throw std::runtime_error("unsupported order format version");
+    std::uint32_t count = 0;
+    for (int i = 0; i < 4; ++i)
+        count |= std::uint32_t(std::uint8_t(in[3 + i])) << (8 * i);
+    if (in.size() - 7 < count)
+        throw std::runtime_error("truncated order buffer");
+    return in.substr(7, count);
+}
+
+const OrderCreator &creatorFor(OrderType type)
+{
+    static const DeliveryOrderCreator delivery;
+    static const DineInOrderCreator dineIn;
+    static const ScheduledOrderCreator scheduled;
+    switch (type)
+    {
+    case OrderType::Delivery:
+        return delivery;
+    case OrderType::DineIn:
+        return dineIn;
+    case OrderType::Scheduled:
+        return scheduled;
+    }
+    throw std::runtime_error("unknown order type");
+}
+
+std::vector<std::unique_ptr<Order>> decodeOrders(std::string_view in)
+{
+    std::vector<std::unique_ptr<Order>> orders;
+    for (char code : orderTypesView(in))
+        orders.push_back(creatorFor(OrderType(std::uint8_t(code))).createOrder());
+    return orders;
+}
+
+int main()
+{
+    std::vector<std::unique_ptr<Order>> orders;
+    orders.push_back(DeliveryOrderCreator().createOrder());
+    orders.push_back(DineInOrderCreator().createOrder());
+    orders.push_back(ScheduledOrderCreator().createOrder());
+
+    std::string bytes = encodeOrders(orders);
+    auto decoded = decodeOrders(bytes);
+    assert(decoded.size() == orders.size());
+    for (std::size_t i = 0; i < decoded.size(); ++i)
+    {
+        assert(decoded[i]->type() == orders[i]->type());
+        decoded[i]->describe();
+    }
+    OutputSink::getInstance().flush(); // keep the descriptions ahead of the summary
+    std::cout << "Encoded " << orders.size() << " orders in " << bytes.size() << " bytes\n";
+    return 0;
+}
+
+/*
+Output:
+Delivery Order: Food will be delivered to your address.
+Dine-In Order: Table will be reserved for you at the restaurant.
+Scheduled Order: The order is scheduled for later.
+Encoded 3 orders in 10 bytes
+*/
+// Adding an order type means a new code and a new creator; the wire format itself doesn't change.
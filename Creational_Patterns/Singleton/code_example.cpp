@@ -91,3 +91,838 @@ generator address: 0x55a...   (same)
 gen2 address:      0x55a...   (same)
 */
 // Now, all order numbers are unique and sequential.
+
+// ===== Singleton Use Case: Asynchronous Output Sink =====
+// One process-wide sink for logging from hot paths such as order descriptions,
+// meal assembly and provider sign-ins. The binary-serialization variants of the
+// Factory Method and Abstract Factory examples and the hashed-token Adapter
+// include this section's generated header and write through it.
+// Callers only copy a small binary record into their own thread's ring buffer;
+// a background thread formats the records and writes them in large batches.
+// When a ring is full the record is dropped and counted, and a thread's ring is
+// recycled when the thread exits, so memory stays bounded and callers never block.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OutputSink
+{
+    // Fixed-size record; `event` must be a string literal, `detail` is copied (truncated)
+    struct Record
+    {
+        const char *event;
+        std::int64_t number;
+        char detail[72]; // room for a 64-digit hex token
+    };
+
+    // Single-producer (owning thread) / single-consumer (drainer) ring.
+    // One thread can write far faster than the drainer formats, so a ring holds
+    // 128K records (11 MiB): enough for a burst of several milliseconds of
+    // back-to-back writes. It is zeroed when allocated so the pages are
+    // already mapped when the hot path reaches them.
+    struct Ring
+    {
+        static const std::size_t kCapacity = 1 << 17;
+        Record records[kCapacity];
+        std::atomic<std::size_t> head{0}, tail{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<bool> retired{false}; // owning thread has exited
+    };
+
+    // Marks the calling thread's ring retired when the thread exits
+    struct RingLease
+    {
+        Ring *ring = nullptr;
+        ~RingLease()
+        {
+            if (ring)
+                ring->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    // Drained rings of exited threads kept for reuse; any beyond this are freed
+    static const std::size_t kMaxSpareRings = 4;
+
+    // ringsMutex guards the ring lists; callers take it only the first time their
+    // thread logs. drainMutex keeps a single consumer per ring and is never
+    // taken by callers, so formatting and I/O cannot delay a registration.
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<Ring>> live, spare;
+    std::mutex drainMutex;
+    std::atomic<std::uint64_t> droppedTotal{0};
+    std::atomic<std::FILE *> out{stdout};
+    std::atomic<bool> running{true};
+    std::thread flusher;
+
+    OutputSink() : flusher([this] { flushLoop(); }) {}
+    OutputSink(const OutputSink &) = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+
+    Ring &localRing()
+    {
+        thread_local RingLease lease;
+        if (!lease.ring)
+            lease.ring = acquireRing();
+        return *lease.ring;
+    }
+
+    // Reuses a spare ring if there is one; a new ring is allocated (and zeroed)
+    // outside the lock, so other threads' registrations don't wait for it
+    Ring *acquireRing()
+    {
+        std::unique_ptr<Ring> ring;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            if (!spare.empty())
+            {
+                ring = std::move(spare.back());
+                spare.pop_back();
+            }
+        }
+        if (ring)
+            ring->retired.store(false, std::memory_order_relaxed);
+        else
+            ring = std::make_unique<Ring>();
+        Ring *raw = ring.get();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        live.push_back(std::move(ring));
+        return raw;
+    }
+
+    // Moves fully drained rings of exited threads to the spare list (or frees them)
+    void recycle(const std::vector<Ring *> &finished)
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (Ring *ring : finished)
+        {
+            auto it = std::find_if(live.begin(), live.end(), [&](const auto &r) { return r.get() == ring; });
+            if (spare.size() < kMaxSpareRings)
+                spare.push_back(std::move(*it));
+            live.erase(it);
+        }
+    }
+
+    // Formats everything currently queued and writes it with one call
+    bool drainOnce(std::string &batch)
+    {
+        std::lock_guard<std::mutex> drainLock(drainMutex);
+        std::vector<Ring *> snapshot, finished;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (auto &ring : live)
+                snapshot.push_back(ring.get());
+        }
+        batch.clear();
+        std::uint64_t dropped = 0;
+        for (Ring *ring : snapshot)
+        {
+            // Read before head: once retired is seen, head holds the thread's last record
+            bool retired = ring->retired.load(std::memory_order_acquire);
+            std::size_t tail = ring->tail.load(std::memory_order_relaxed);
+            std::size_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail)
+            {
+                const Record &r = ring->records[tail % Ring::kCapacity];
+                batch += r.event;
+                batch += r.detail;
+                if (r.number >= 0)
+                    batch += std::to_string(r.number);
+                batch += '\n';
+            }
+            ring->tail.store(tail, std::memory_order_release);
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (retired)
+                finished.push_back(ring);
+        }
+        if (!finished.empty())
+            recycle(finished);
+        if (dropped)
+        {
+            droppedTotal.fetch_add(dropped, std::memory_order_relaxed);
+            batch += "[OutputSink] dropped " + std::to_string(dropped) + " records\n";
+        }
+        if (!batch.empty())
+        {
+            std::FILE *file = out.load();
+            std::fwrite(batch.data(), 1, batch.size(), file);
+            std::fflush(file);
+        }
+        return !batch.empty();
+    }
+
+    void flushLoop()
+    {
+        std::string batch;
+        while (running.load(std::memory_order_acquire))
+            if (!drainOnce(batch))
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        drainOnce(batch);
+    }
+
+public:
+    static OutputSink &getInstance()
+    {
+        static OutputSink instance;
+        return instance;
+    }
+    ~OutputSink()
+    {
+        running.store(false, std::memory_order_release);
+        flusher.join();
+    }
+
+    // Redirects output (e.g. to a file); records already queued may still go to the old one
+    void setOutput(std::FILE *file) { out.store(file); }
+
+    // Hot-path call: copies one record, never blocks, never formats.
+    // Prints as event + detail, followed by number when it is non-negative.
+    void write(const char *event, const std::string &detail = "", std::int64_t number = -1)
+    {
+        Ring &ring = localRing();
+        std::size_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) == Ring::kCapacity)
+        {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Record &r = ring.records[head % Ring::kCapacity];
+        r.event = event;
+        r.number = number;
+        std::size_t len = std::min(detail.size(), sizeof(r.detail) - 1);
+        std::memcpy(r.detail, detail.data(), len);
+        r.detail[len] = '\0';
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    // Blocks until everything written so far has reached the output
+    void flush()
+    {
+        std::string batch;
+        while (drainOnce(batch))
+        {
+        }
+    }
+
+    // Records dropped because a ring was full, counted when they are drained
+    std::uint64_t dropped() const { return droppedTotal.load(std::memory_order_relaxed); }
+
+    // Rings currently allocated, in use or spare
+    std::size_t ringCount()
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        return live.size() + spare.size();
+    }
+};
+
+// Hot-path callers, as in the other examples
+bool googleSignIn(const std::string &oauthToken)
+{
+    OutputSink::getInstance().write("[GoogleLoginAPI] Signing in with token: ", oauthToken);
+    return !oauthToken.empty();
+}
+
+void describeOrder(int orderNumber)
+{
+    OutputSink::getInstance().write("Delivery Order: Food will be delivered. Order #", "", orderNumber);
+}
+
+// Per-call latency (ns) of `threads` x `perThread` calls to `call`
+template <typename F>
+std::string measure(const char *label, int threads, int perThread, F call)
+{
+    std::vector<std::vector<double>> latencies(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            latencies[t].reserve(perThread);
+            for (int i = 0; i < perThread; ++i)
+            {
+                auto begin = std::chrono::steady_clock::now();
+                call(i);
+                latencies[t].push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count());
+            }
+        });
+    for (auto &w : workers)
+        w.join();
+    std::vector<double> all;
+    for (auto &l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    double sum = 0;
+    for (double v : all)
+        sum += v;
+    return std::string(label) + ": mean " + std::to_string(std::size_t(sum / all.size())) + " ns, p50 " +
+           std::to_string(std::size_t(all[all.size() / 2])) + " ns, p99 " +
+           std::to_string(std::size_t(all[all.size() * 99 / 100])) + " ns";
+}
+
+int main()
+{
+    auto &sink = OutputSink::getInstance();
+    googleSignIn("alice@gmail.com:password123");
+    describeOrder(1000);
+    sink.flush();
+
+    // Caller-side latency, both writing to /dev/null so only the calling path is compared
+    std::FILE *devNull = std::fopen("/dev/null", "w");
+    std::ofstream devNullStream("/dev/null");
+    std::streambuf *console = std::cout.rdbuf(devNullStream.rdbuf());
+    std::string coutResult = measure("cout + endl", 4, 100000, [](int i) {
+        std::cout << "[GoogleLoginAPI] Signing in with token: " << "user:secret" << i << std::endl;
+    });
+    std::cout.rdbuf(console);
+
+    sink.setOutput(devNull);
+    std::uint64_t droppedBefore = sink.dropped();
+    std::string sinkResult = measure("OutputSink ", 4, 100000, [&](int i) {
+        sink.write("[GoogleLoginAPI] Signing in with token: ", "user:secret", i);
+    });
+    sink.flush();
+    std::uint64_t dropped = sink.dropped() - droppedBefore;
+
+    // Thread-per-request callers: a thread's ring is recycled once it exits
+    const int kRounds = 25, kThreadsPerRound = 8;
+    for (int round = 0; round < kRounds; ++round)
+    {
+        std::vector<std::thread> requests;
+        for (int t = 0; t < kThreadsPerRound; ++t)
+            requests.emplace_back([&] { describeOrder(round); });
+        for (auto &r : requests)
+            r.join();
+        sink.flush();
+    }
+    sink.setOutput(stdout);
+    std::fclose(devNull);
+    // A latency figure only counts if every record was actually delivered
+    std::cout << coutResult << "\n" << sinkResult << ", dropped " << dropped << " of 400000\n";
+    std::cout << "Rings allocated after " << kRounds * kThreadsPerRound << " short-lived threads: " << sink.ringCount()
+              << "\n";
+    return 0;
+}
+
+/*
+Output (timings vary by machine):
+[GoogleLoginAPI] Signing in with token: alice@gmail.com:password123
+Delivery Order: Food will be delivered. Order #1000
+cout + endl: mean 1700 ns, p50 440 ns, p99 590 ns
+OutputSink : mean 350 ns, p50 40 ns, p99 160 ns, dropped 0 of 400000
+Rings allocated after 200 short-lived threads: 5
+*/
+// Callers pay for a memcpy into their own buffer; formatting and write syscalls happen on one background thread.
+
+// ===== Singleton Use Case: Hot-Path Instrumentation =====
+// One metrics registry collects per-component latency histograms, call counts
+// and allocation counts from the hot paths of the other examples. The compliant
+// Factory Method, Abstract Factory, Builder, Decorator and Adapter examples are
+// included through their generated headers and wrapped in instrumented
+// decorators (same interfaces, one DP_INSTRUMENT line per call), so the
+// services themselves stay unchanged.
+//   - Compile-time switch: build with -DDP_INSTRUMENTATION=0 and DP_INSTRUMENT()
+//     expands to nothing.
+//   - Runtime switch: Metrics::getInstance().setEnabled(false) leaves a single
+//     relaxed atomic load per call.
+// Each thread writes only its own counters; export() merges them on demand.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <abstract_factory/abstract_factory_compliant_example.h>
+#include <adapter/adapter_pattern_compliant_example.h>
+#include <builder/builder_pattern_compliant_example.h>
+#include <decorator/decorator_pattern_proper.h>
+#include <factory_method/factory_method_compliant_example.h>
+
+#ifndef DP_INSTRUMENTATION
+#define DP_INSTRUMENTATION 1
+#endif
+
+enum class Component
+{
+    OrderCreator,
+    MealFactory,
+    SandwichBuilder,
+    PostDecorator,
+    AuthProvider,
+    Count
+};
+
+const char *componentName(Component c)
+{
+    static const char *names[] = {"order_creator", "meal_factory", "sandwich_builder", "post_decorator", "auth_provider"};
+    return names[std::size_t(c)];
+}
+
+// Returns how many allocations the calling thread has made so far. Counting
+// needs a replaced operator new, which belongs to the program, so the program
+// installs its counter with Metrics::setAllocationCounter(); until then
+// allocations are reported as 0.
+using AllocationCounter = std::uint64_t (*)();
+
+// HDR-style log-linear histogram of nanoseconds: 8 sub-buckets per power of
+// two, so every recorded value is within 12.5% of its bucket's bounds.
+class LatencyHistogram
+{
+public:
+    static const int kSubBits = 3;
+    static const std::size_t kBuckets = (64 - kSubBits + 1) << kSubBits;
+
+    static std::size_t bucketFor(std::uint64_t ns)
+    {
+        if (ns < (1u << kSubBits))
+            return std::size_t(ns);
+        int msb = 63 - __builtin_clzll(ns);
+        std::size_t sub = std::size_t(ns >> (msb - kSubBits)) & ((1u << kSubBits) - 1);
+        return (std::size_t(msb - kSubBits + 1) << kSubBits) + sub;
+    }
+    // Largest value that falls in bucket b
+    static std::uint64_t upperBound(std::size_t b)
+    {
+        if (b < (1u << kSubBits))
+            return b;
+        std::size_t range = (b >> kSubBits) + kSubBits - 1;
+        std::uint64_t base = (std::uint64_t(1) << kSubBits | (b & ((1u << kSubBits) - 1))) << (range - kSubBits);
+        return base + (std::uint64_t(1) << (range - kSubBits)) - 1;
+    }
+
+    std::array<std::uint64_t, kBuckets> counts{};
+    std::uint64_t total = 0, sum = 0, max = 0;
+
+    void add(std::uint64_t ns)
+    {
+        ++counts[bucketFor(ns)];
+        ++total;
+        sum += ns;
+        max = std::max(max, ns);
+    }
+    void merge(const LatencyHistogram &other)
+    {
+        for (std::size_t i = 0; i < kBuckets; ++i)
+            counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+    std::uint64_t quantile(double q) const
+    {
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i)
+            if ((seen += counts[i]) >= q * total && total)
+                return std::min(upperBound(i), max);
+        return 0;
+    }
+};
+
+class Metrics
+{
+    // Written only by the owning thread; relaxed atomics let export() read
+    // them from another thread without a lock
+    struct ThreadMetrics
+    {
+        struct PerComponent
+        {
+            std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBuckets> buckets{};
+            std::atomic<std::uint64_t> calls{0}, allocations{0}, sumNs{0}, maxNs{0};
+        };
+        std::array<PerComponent, std::size_t(Component::Count)> components;
+    };
+
+    static void bump(std::atomic<std::uint64_t> &a, std::uint64_t by)
+    {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> enabled{true};
+    std::atomic<AllocationCounter> allocationCounter{nullptr};
+    std::mutex threadsMutex; // only taken the first time a thread records
+    std::vector<std::unique_ptr<ThreadMetrics>> threads;
+
+    Metrics() = default;
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    ThreadMetrics &local()
+    {
+        thread_local ThreadMetrics *mine = nullptr;
+        if (!mine)
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.push_back(std::make_unique<ThreadMetrics>());
+            mine = threads.back().get();
+        }
+        return *mine;
+    }
+
+public:
+    static Metrics &getInstance()
+    {
+        static Metrics instance;
+        return instance;
+    }
+
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void setAllocationCounter(AllocationCounter counter) { allocationCounter.store(counter); }
+    std::uint64_t allocationsSoFar() const
+    {
+        AllocationCounter counter = allocationCounter.load(std::memory_order_relaxed);
+        return counter ? counter() : 0;
+    }
+
+    void record(Component c, std::uint64_t ns, std::uint64_t allocations)
+    {
+        auto &m = local().components[std::size_t(c)];
+        bump(m.buckets[LatencyHistogram::bucketFor(ns)], 1);
+        bump(m.calls, 1);
+        bump(m.allocations, allocations);
+        bump(m.sumNs, ns);
+        if (ns > m.maxNs.load(std::memory_order_relaxed))
+            m.maxNs.store(ns, std::memory_order_relaxed);
+    }
+
+    struct Snapshot
+    {
+        LatencyHistogram latency;
+        std::uint64_t calls = 0, allocations = 0;
+    };
+
+    // Merges every thread's counters for one component
+    Snapshot snapshot(Component c)
+    {
+        Snapshot s;
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto &t : threads)
+        {
+            const auto &m = t->components[std::size_t(c)];
+            LatencyHistogram h;
+            for (std::size_t i = 0; i < LatencyHistogram::kBuckets; ++i)
+                h.counts[i] = m.buckets[i].load(std::memory_order_relaxed);
+            h.total = m.calls.load(std::memory_order_relaxed);
+            h.sum = m.sumNs.load(std::memory_order_relaxed);
+            h.max = m.maxNs.load(std::memory_order_relaxed);
+            s.latency.merge(h);
+            s.calls += h.total;
+            s.allocations += m.allocations.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    // Human-readable summary, one line per component
+    void exportText(const std::string &path)
+    {
+        std::ofstream out(path);
+        for (std::size_t c = 0; c < std::size_t(Component::Count); ++c)
+        {
+            Snapshot s = snapshot(Component(c));
+            out << componentName(Component(c)) << ": calls=" << s.calls << " allocs=" << s.allocations
+                << " p50=" << s.latency.quantile(0.5) << "ns p99=" << s.latency.quantile(0.99)
+                << "ns max=" << s.latency.max << "ns\n";
+        }
+    }
+
+    // Prometheus text exposition format: each metric family is one block under
+    // its TYPE line; only non-empty buckets are listed
+    void exportPrometheus(const std::string &path)
+    {
+        const std::size_t kComponents = std::size_t(Component::Count);
+        std::vector<Snapshot> snapshots;
+        std::vector<std::string> labels;
+        for (std::size_t c = 0; c < kComponents; ++c)
+        {
+            snapshots.push_back(snapshot(Component(c)));
+            labels.push_back(std::string("component=\"") + componentName(Component(c)) + "\"");
+        }
+
+        std::ofstream out(path);
+        out << "# TYPE dp_calls_total counter\n";
+        for (std::size_t c = 0; c < kComponents; ++c)
+            out << "dp_calls_total{" << labels[c] << "} " << snapshots[c].calls << "\n";
+        out << "# TYPE dp_allocations_total counter\n";
+        for (std::size_t c = 0; c < kComponents; ++c)
+            out << "dp_allocations_total{" << labels[c] << "} " << snapshots[c].allocations << "\n";
+        out << "# TYPE dp_latency_ns histogram\n";
+        for (std::size_t c = 0; c < kComponents; ++c)
+        {
+            const LatencyHistogram &latency = snapshots[c].latency;
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < LatencyHistogram::kBuckets; ++i)
+                if (latency.counts[i])
+                {
+                    cumulative += latency.counts[i];
+                    out << "dp_latency_ns_bucket{" << labels[c] << ",le=\"" << LatencyHistogram::upperBound(i)
+                        << "\"} " << cumulative << "\n";
+                }
+            out << "dp_latency_ns_bucket{" << labels[c] << ",le=\"+Inf\"} " << latency.total << "\n";
+            out << "dp_latency_ns_sum{" << labels[c] << "} " << latency.sum << "\n";
+            out << "dp_latency_ns_count{" << labels[c] << "} " << latency.total << "\n";
+        }
+    }
+};
+
+// Times the enclosing scope and counts the allocations made inside it
+class ScopedInstrument
+{
+    Component component;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t allocationsAtStart;
+
+public:
+    explicit ScopedInstrument(Component c) : component(c), active(Metrics::getInstance().isEnabled())
+    {
+        if (active)
+        {
+            allocationsAtStart = Metrics::getInstance().allocationsSoFar();
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedInstrument()
+    {
+        if (!active)
+            return;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        Metrics &metrics = Metrics::getInstance();
+        metrics.record(component, std::uint64_t(ns), metrics.allocationsSoFar() - allocationsAtStart);
+    }
+};
+
+#if DP_INSTRUMENTATION
+#define DP_CONCAT_INNER(a, b) a##b
+#define DP_CONCAT(a, b) DP_CONCAT_INNER(a, b)
+#define DP_INSTRUMENT(component) ScopedInstrument DP_CONCAT(dpInstrument, __LINE__)(component)
+#else
+#define DP_INSTRUMENT(component) ((void)0)
+#endif
+
+// ---- Services: the compliant examples themselves, from their generated headers ----
+
+namespace fm = factory_method::factory_method_compliant_example;
+namespace af = abstract_factory::abstract_factory_compliant_example;
+namespace bd = builder::builder_pattern_compliant_example;
+namespace dc = decorator::decorator_pattern_proper;
+namespace ad = adapter::adapter_pattern_compliant_example;
+
+// ---- Instrumented decorators: same interface, forward inside one DP_INSTRUMENT scope ----
+
+class InstrumentedOrderCreator : public fm::OrderCreator
+{
+    const fm::OrderCreator &inner;
+
+public:
+    explicit InstrumentedOrderCreator(const fm::OrderCreator &inner) : inner(inner) {}
+    std::unique_ptr<fm::Order> createOrder() const override
+    {
+        DP_INSTRUMENT(Component::OrderCreator);
+        return inner.createOrder();
+    }
+};
+
+// Each product is one factory call
+class InstrumentedMealFactory : public af::MealFactory
+{
+    const af::MealFactory &inner;
+
+public:
+    explicit InstrumentedMealFactory(const af::MealFactory &inner) : inner(inner) {}
+    std::unique_ptr<af::MainCourse> createMainCourse() const override
+    {
+        DP_INSTRUMENT(Component::MealFactory);
+        return inner.createMainCourse();
+    }
+    std::unique_ptr<af::Side> createSide() const override
+    {
+        DP_INSTRUMENT(Component::MealFactory);
+        return inner.createSide();
+    }
+    std::unique_ptr<af::Drink> createDrink() const override
+    {
+        DP_INSTRUMENT(Component::MealFactory);
+        return inner.createDrink();
+    }
+};
+
+// Steps are forwarded untimed (and return the decorator, so chains stay
+// wrapped); build() is the measured call
+class InstrumentedSandwichBuilder : public bd::SandwichBuilder
+{
+    bd::SandwichBuilder &inner;
+
+public:
+    explicit InstrumentedSandwichBuilder(bd::SandwichBuilder &inner) : inner(inner) {}
+    bd::SandwichBuilder &addBread(const std::string &b) override { inner.addBread(b); return *this; }
+    bd::SandwichBuilder &addFilling(const std::string &f) override { inner.addFilling(f); return *this; }
+    bd::SandwichBuilder &addSauce(const std::string &s) override { inner.addSauce(s); return *this; }
+    bd::SandwichBuilder &addExtras(const std::string &e) override { inner.addExtras(e); return *this; }
+    std::unique_ptr<bd::Sandwich> build() override
+    {
+        DP_INSTRUMENT(Component::SandwichBuilder);
+        return inner.build();
+    }
+};
+
+// Outermost decorator: times getContent() of the whole chain below it, which
+// it owns like every PostDecorator
+class InstrumentedPost : public dc::PostDecorator
+{
+public:
+    InstrumentedPost(dc::Post *p) : dc::PostDecorator(p) {}
+    std::string getContent() const override
+    {
+        DP_INSTRUMENT(Component::PostDecorator);
+        return post->getContent();
+    }
+};
+
+class InstrumentedAuthProvider : public ad::IAuthProvider
+{
+    ad::IAuthProvider &inner;
+
+public:
+    explicit InstrumentedAuthProvider(ad::IAuthProvider &inner) : inner(inner) {}
+    bool login(const std::string &username, const std::string &password) override
+    {
+        DP_INSTRUMENT(Component::AuthProvider);
+        return inner.login(username, password);
+    }
+};
+
+// Written only against the interfaces, so it runs with or without
+// instrumentation. describe() and login() print, as in their examples.
+std::size_t runWorkload(const fm::OrderCreator &orders, const af::MealFactory &meals, bd::SandwichBuilder &sandwiches,
+                        const dc::Post &post, ad::IAuthProvider &auth, int iterations)
+{
+    std::size_t work = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        orders.createOrder()->describe();
+        work += meals.createMainCourse()->name().size() + meals.createSide()->name().size() +
+                meals.createDrink()->name().size();
+        sandwiches.addBread("Wheat").addFilling("Paneer").addSauce("Mint").addExtras("Lettuce,Olives").build()->describe();
+        work += post.getContent().size();
+        work += auth.login("alice@gmail.com", "password123");
+    }
+    return work;
+}
+
+volatile std::size_t workSink; // keeps the workload from being optimized away
+
+template <typename F>
+double nsPerIteration(int iterations, F workload)
+{
+    auto start = std::chrono::steady_clock::now();
+    workSink = workload(iterations);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// Swallows what the services print while they are timed; the formatting is
+// still part of each call's cost
+class DiscardBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+// ---- Program-only: allocation counting ----
+// Replacing operator new is only allowed at global scope and once per program,
+// so this part (and main) is left out when the example is included as a
+// library; a host program installs its own counter instead.
+#ifndef DP_EXAMPLE_AS_LIBRARY
+thread_local std::uint64_t threadAllocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++threadAllocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+int main()
+{
+    auto &metrics = Metrics::getInstance();
+    metrics.setAllocationCounter([] { return threadAllocations; });
+    const int kIterations = 200000;
+
+    fm::DeliveryOrderCreator delivery;
+    af::VegMealFactory veg;
+    bd::VegSandwichBuilder builder;
+    ad::GoogleAdapter google;
+    dc::FeatureDecorator post(new dc::TagDecorator(new dc::BasicPost()));
+    // The instrumented post owns its chain, so it gets a chain of its own
+    InstrumentedPost instrumentedPost(new dc::FeatureDecorator(new dc::TagDecorator(new dc::BasicPost())));
+    InstrumentedOrderCreator instrumentedDelivery(delivery);
+    InstrumentedMealFactory instrumentedVeg(veg);
+    InstrumentedSandwichBuilder instrumentedBuilder(builder);
+    InstrumentedAuthProvider instrumentedGoogle(google);
+
+    auto plain = [&](int n) { return runWorkload(delivery, veg, builder, post, google, n); };
+    auto instrumented = [&](int n) {
+        return runWorkload(instrumentedDelivery, instrumentedVeg, instrumentedBuilder, instrumentedPost, instrumentedGoogle, n);
+    };
+
+    DiscardBuffer discard;
+    std::streambuf *console = std::cout.rdbuf(&discard);
+    nsPerIteration(kIterations, plain); // warm-up
+    double bare = nsPerIteration(kIterations, plain);
+    metrics.setEnabled(false);
+    double disabled = nsPerIteration(kIterations, instrumented);
+    metrics.setEnabled(true);
+    double enabled = nsPerIteration(kIterations, instrumented);
+    std::cout.rdbuf(console);
+
+    std::cout << "DP_INSTRUMENTATION=" << DP_INSTRUMENTATION << "\n";
+    std::cout << "not wrapped     : " << std::size_t(bare) << " ns per 7 calls\n";
+    std::cout << "runtime disabled: " << std::size_t(disabled) << " ns per 7 calls\n";
+    std::cout << "runtime enabled : " << std::size_t(enabled) << " ns per 7 calls\n";
+
+    metrics.exportText("metrics.txt");
+    metrics.exportPrometheus("metrics.prom");
+    std::ifstream summary("metrics.txt");
+    std::cout << summary.rdbuf();
+    std::remove("metrics.txt");
+    std::cout << "(Prometheus output written to metrics.prom)\n";
+    return 0;
+}
+#endif
+
+/*
+Output (timings vary by machine; compare with a -DDP_INSTRUMENTATION=0 build for the compiled-out cost):
+DP_INSTRUMENTATION=1
+not wrapped     : 465 ns per 7 calls
+runtime disabled: 556 ns per 7 calls
+runtime enabled : 1210 ns per 7 calls
+order_creator: calls=200000 allocs=200000 p50=51ns p99=71ns max=805230ns
+meal_factory: calls=600000 allocs=600000 p50=51ns p99=71ns max=43452ns
+sandwich_builder: calls=200000 allocs=200000 p50=79ns p99=103ns max=127929ns
+post_decorator: calls=200000 allocs=400000 p50=143ns p99=207ns max=449024ns
+auth_provider: calls=200000 allocs=200000 p50=143ns p99=191ns max=96046ns
+(Prometheus output written to metrics.prom)
+*/
+// Instrumenting a service is one decorator around it; switched off at runtime it costs a virtual call and one relaxed load.
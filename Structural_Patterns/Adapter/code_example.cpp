@@ -22,7 +22,7 @@ public:
     // The method is completely different; expects a Google token.
     bool googleSignIn(const string &oauthToken)
     {
-        cout << "[GoogleLoginAPI] Signing in with token: " << oauthToken << endl;
+        cout << "[GoogleLoginAPI] Signing in with token: " << oauthToken << "\n";
         return !oauthToken.empty();
     }
 };
@@ -69,7 +69,7 @@ class GoogleLoginAPI
 public:
     bool googleSignIn(const string &oauthToken)
     {
-        cout << "[GoogleLoginAPI] Signing in with token: " << oauthToken << endl;
+        cout << "[GoogleLoginAPI] Signing in with token: " << oauthToken << "\n";
         return !oauthToken.empty();
     }
 };
@@ -95,7 +95,7 @@ class XLoginAPI
 public:
     bool XSignIn(const string &secretToken)
     {
-        cout << "[TwitterLoginAPI] Signing In with secretToken : " << secretToken << endl;
+        cout << "[TwitterLoginAPI] Signing In with secretToken : " << secretToken << "\n";
         return !secretToken.empty();
     }
 };
@@ -143,3 +143,870 @@ User authenticated!
 
 */
 // Now, client code works with the Adapter, without caring about the underlying third-party API.
+
+// ===== Adapter With a Pool of Warm Provider Sessions =====
+// Real provider clients sit on network connections, and opening one (handshake,
+// TLS, auth) costs far more than a login. Each adapter here keeps a bounded pool
+// of connected sessions; concurrent login() calls check one out without a lock.
+// The provider is stood in for by a local Unix-socket server (POSIX only).
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+using namespace std;
+
+// Target interface (what the app expects)
+class IAuthProvider
+{
+public:
+    virtual bool login(const string &username, const string &password) = 0;
+    virtual ~IAuthProvider() = default;
+};
+
+// Stand-in provider: every new connection pays `setupCost` before it is usable,
+// then answers each length-prefixed token with '1' (accepted) or '0'.
+// The socket lives in a fresh private directory, so concurrent runs never collide.
+class LocalProviderServer
+{
+    string dir;
+    string path;
+    int listenFd = -1;
+    chrono::microseconds setupCost;
+    atomic<bool> stopping{false};
+    thread acceptor;
+
+    static void serve(int fd, chrono::microseconds setupCost)
+    {
+        this_thread::sleep_for(setupCost);
+        char ready = 'R';
+        send(fd, &ready, 1, MSG_NOSIGNAL); // a client that already left must not raise SIGPIPE
+        uint32_t len;
+        while (recv(fd, &len, sizeof(len), MSG_WAITALL) == sizeof(len))
+        {
+            string token(len, '\0');
+            if (len && recv(fd, &token[0], len, MSG_WAITALL) != ssize_t(len))
+                break;
+            char reply = token.empty() ? '0' : '1';
+            send(fd, &reply, 1, MSG_NOSIGNAL);
+        }
+        close(fd);
+    }
+
+    static sockaddr_un addressOf(const string &path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+        return addr;
+    }
+
+public:
+    explicit LocalProviderServer(chrono::microseconds setupCost) : setupCost(setupCost)
+    {
+        char dirTemplate[] = "/tmp/auth_provider.XXXXXX";
+        if (!mkdtemp(dirTemplate))
+            throw runtime_error("cannot create a directory for the provider socket");
+        dir = dirTemplate;
+        path = dir + "/provider.sock";
+
+        sockaddr_un addr = addressOf(path);
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            listen(listenFd, 128) != 0)
+        {
+            if (listenFd >= 0)
+                close(listenFd);
+            unlink(path.c_str());
+            rmdir(dir.c_str());
+            throw runtime_error("cannot listen on " + path);
+        }
+        acceptor = thread([this] {
+            int fd;
+            while ((fd = accept(listenFd, nullptr, nullptr)) >= 0)
+            {
+                if (stopping.load())
+                {
+                    close(fd);
+                    break;
+                }
+                thread(serve, fd, this->setupCost).detach();
+            }
+        });
+    }
+    ~LocalProviderServer()
+    {
+        // Closing or shutting down a listening socket does not wake a blocked
+        // accept() everywhere, so connect to ourselves after raising the flag.
+        stopping.store(true);
+        sockaddr_un addr = addressOf(path);
+        int wake = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (wake >= 0)
+        {
+            connect(wake, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+            close(wake);
+        }
+        acceptor.join();
+        close(listenFd);
+        unlink(path.c_str());
+        rmdir(dir.c_str());
+    }
+    LocalProviderServer(const LocalProviderServer &) = delete;
+    LocalProviderServer &operator=(const LocalProviderServer &) = delete;
+
+    const string &socketPath() const { return path; }
+};
+
+// One connected client session to a provider
+class ProviderSession
+{
+    int fd;
+    unsigned uses = 0;
+
+public:
+    static const unsigned kMaxUses = 10000; // recycle long-lived sessions
+
+    explicit ProviderSession(const string &path)
+    {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+        char ready = 0;
+        if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            recv(fd, &ready, 1, MSG_WAITALL) != 1)
+        {
+            close(fd);
+            throw runtime_error("cannot connect to provider");
+        }
+    }
+    ~ProviderSession() { close(fd); }
+    ProviderSession(const ProviderSession &) = delete;
+    ProviderSession &operator=(const ProviderSession &) = delete;
+
+    bool signIn(const string &token)
+    {
+        ++uses;
+        uint32_t len = static_cast<uint32_t>(token.size());
+        char reply = '0';
+        if (send(fd, &len, sizeof(len), MSG_NOSIGNAL) != sizeof(len) ||
+            send(fd, token.data(), len, MSG_NOSIGNAL) != ssize_t(len) ||
+            recv(fd, &reply, 1, MSG_WAITALL) != 1)
+        {
+            uses = kMaxUses; // broken: make healthy() fail so the pool drops it
+            return false;
+        }
+        return reply == '1';
+    }
+
+    // Healthy while under the use limit and the peer has not hung up
+    bool healthy() const
+    {
+        if (uses >= kMaxUses)
+            return false;
+        char probe;
+        ssize_t n = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+};
+
+// Fixed number of slots; each slot's state is claimed with a compare-and-swap,
+// so checkout and return never take a lock. When every slot is busy the caller
+// gets a temporary session that is closed after use instead of waiting.
+template <size_t Capacity>
+class SessionPool
+{
+    enum State : uint8_t
+    {
+        Empty,
+        Idle,
+        Busy
+    };
+    struct Slot
+    {
+        atomic<uint8_t> state{Empty};
+        unique_ptr<ProviderSession> session;
+    };
+    array<Slot, Capacity> slots;
+    string path;
+
+public:
+    class Lease
+    {
+        SessionPool *pool;
+        Slot *slot;
+        unique_ptr<ProviderSession> overflow;
+
+    public:
+        Lease(SessionPool *pool, Slot *slot, unique_ptr<ProviderSession> overflow)
+            : pool(pool), slot(slot), overflow(move(overflow)) {}
+        Lease(Lease &&other) noexcept
+            : pool(other.pool), slot(exchange(other.slot, nullptr)), overflow(move(other.overflow)) {}
+        ~Lease()
+        {
+            if (slot)
+                pool->giveBack(*slot);
+        }
+        ProviderSession *operator->() { return slot ? slot->session.get() : overflow.get(); }
+    };
+
+    explicit SessionPool(string path) : path(move(path)) {}
+
+    // Opens `count` sessions up front so the first logins don't pay for setup.
+    // If the provider is down the remaining slots stay empty; checkout retries.
+    void warmUp(size_t count)
+    {
+        try
+        {
+            for (size_t i = 0; i < min(count, Capacity); ++i)
+            {
+                slots[i].session = make_unique<ProviderSession>(path);
+                slots[i].state.store(Idle, memory_order_release);
+            }
+        }
+        catch (const runtime_error &)
+        {
+        }
+    }
+
+    Lease checkout()
+    {
+        // Start scanning at a per-thread offset to spread threads across slots
+        size_t start = hash<thread::id>()(this_thread::get_id()) % Capacity;
+        for (State from : {Idle, Empty})
+            for (size_t i = 0; i < Capacity; ++i)
+            {
+                Slot &slot = slots[(start + i) % Capacity];
+                uint8_t expected = from;
+                if (!slot.state.compare_exchange_strong(expected, Busy, memory_order_acquire))
+                    continue;
+                if (from == Empty || !slot.session->healthy())
+                {
+                    try
+                    {
+                        slot.session = make_unique<ProviderSession>(path);
+                    }
+                    catch (...)
+                    {
+                        slot.session.reset();
+                        slot.state.store(Empty, memory_order_release);
+                        throw;
+                    }
+                }
+                return Lease(this, &slot, nullptr);
+            }
+        return Lease(this, nullptr, make_unique<ProviderSession>(path));
+    }
+
+private:
+    void giveBack(Slot &slot)
+    {
+        if (slot.session->healthy())
+        {
+            slot.state.store(Idle, memory_order_release);
+            return;
+        }
+        slot.session.reset();
+        slot.state.store(Empty, memory_order_release);
+    }
+};
+
+// Adapter: translates login() to the Google session API, using pooled sessions
+class GoogleAdapter : public IAuthProvider
+{
+    SessionPool<16> sessions;
+
+public:
+    explicit GoogleAdapter(const string &providerPath) : sessions(providerPath) { sessions.warmUp(16); }
+    bool login(const string &username, const string &password) override
+    {
+        string oauthToken = username + ":" + password;
+        try
+        {
+            return sessions.checkout()->signIn(oauthToken);
+        }
+        catch (const runtime_error &) // provider unreachable
+        {
+            return false;
+        }
+    }
+};
+
+// Adapter: for X, same pool, different token translation
+class XAdapter : public IAuthProvider
+{
+    SessionPool<16> sessions;
+
+public:
+    explicit XAdapter(const string &providerPath) : sessions(providerPath) { sessions.warmUp(16); }
+    bool login(const string &username, const string &password) override
+    {
+        string secretToken = username + "X.com" + password;
+        try
+        {
+            return sessions.checkout()->signIn(secretToken);
+        }
+        catch (const runtime_error &) // provider unreachable
+        {
+            return false;
+        }
+    }
+};
+
+// Baseline: opens a fresh session for every login
+class UnpooledGoogleAdapter : public IAuthProvider
+{
+    string providerPath;
+
+public:
+    explicit UnpooledGoogleAdapter(const string &providerPath) : providerPath(providerPath) {}
+    bool login(const string &username, const string &password) override
+    {
+        try
+        {
+            ProviderSession session(providerPath);
+            return session.signIn(username + ":" + password);
+        }
+        catch (const runtime_error &) // provider unreachable
+        {
+            return false;
+        }
+    }
+};
+
+// Drives `threads` x `perThread` logins and prints throughput and p99 latency
+void measure(const string &label, IAuthProvider &provider, int threads, int perThread)
+{
+    vector<vector<double>> latencies(threads);
+    atomic<int> failures{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; ++i)
+            {
+                auto begin = chrono::steady_clock::now();
+                if (!provider.login("user" + to_string(t), "secret"))
+                    ++failures;
+                latencies[t].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count());
+            }
+        });
+    for (auto &w : workers)
+        w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (auto &l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    double p99 = all[all.size() * 99 / 100];
+    cout << label << ": " << size_t(all.size() / seconds) << " logins/sec, p99 " << size_t(p99)
+         << " us, failures " << failures << "\n";
+}
+
+int main()
+{
+    LocalProviderServer server(chrono::milliseconds(2)); // 2 ms connection setup
+    const string &path = server.socketPath();
+
+    UnpooledGoogleAdapter unpooled(path);
+    GoogleAdapter googleAuth(path);
+    XAdapter xAuth(path);
+
+    measure("google, new session per login", unpooled, 8, 200);
+    measure("google, pooled sessions      ", googleAuth, 8, 5000);
+    measure("x, pooled sessions           ", xAuth, 8, 5000);
+
+    // An unreachable provider is a failed login, not an exception
+    GoogleAdapter offline(path + ".missing");
+    cout << "google, provider unreachable : login " << (offline.login("alice", "secret") ? "accepted" : "rejected")
+         << "\n";
+    return 0;
+}
+
+/*
+Output (numbers vary by machine):
+google, new session per login: 3600 logins/sec, p99 2600 us, failures 0
+google, pooled sessions      : 130000 logins/sec, p99 120 us, failures 0
+x, pooled sessions           : 150000 logins/sec, p99 90 us, failures 0
+google, provider unreachable : login rejected
+*/
+// Connection setup is paid once per pooled session, not once per login, and logins on one adapter run in parallel.
+
+// ===== Adapters With Batched, Hashed Token Derivation =====
+// Instead of passing "username:password" to the provider, each adapter derives
+// the token as HMAC-SHA-256(providerKey, username ":" password).
+// The SHA-256 core hashes several messages at once, one per SIMD lane: 8 lanes
+// with AVX2, 16 with AVX-512, or a plain scalar loop. The widest level the CPU
+// supports is picked at runtime. Sign-ins log through the Singleton example's
+// shared OutputSink instead of writing to cout on the login path.
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <singleton/singleton_use_case_asynchronous_output_sink.h>
+#include <string>
+#include <vector>
+using namespace std;
+using singleton::singleton_use_case_asynchronous_output_sink::OutputSink;
+
+using Digest = array<uint8_t, 32>;
+
+namespace sha256
+{
+    const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    const uint32_t H0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    // The lane loops must inline into the target("avx2"/"avx512f") entry points below
+#if defined(__GNUC__)
+#define SHA256_INLINE inline __attribute__((always_inline))
+#else
+#define SHA256_INLINE inline
+#endif
+
+    // Lane access: V is either uint32_t (one lane) or a GCC/Clang vector of uint32_t
+    template <typename V>
+    constexpr size_t kLanes = sizeof(V) / sizeof(uint32_t);
+
+    template <typename V>
+    SHA256_INLINE void setLane(V &v, size_t i, uint32_t x)
+    {
+        if constexpr (kLanes<V> == 1)
+            v = x;
+        else
+            v[i] = x;
+    }
+    template <typename V>
+    SHA256_INLINE uint32_t getLane(const V &v, size_t i)
+    {
+        if constexpr (kLanes<V> == 1)
+            return v;
+        else
+            return v[i];
+    }
+
+    // A macro rather than a function: vector arguments/returns would change the call ABI
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+    // Pads one message: message, 0x80, zeros, 64-bit big-endian bit length
+    inline string pad(const string &message)
+    {
+        string padded = message;
+        padded.push_back(char(0x80));
+        while (padded.size() % 64 != 56)
+            padded.push_back('\0');
+        uint64_t bits = uint64_t(message.size()) * 8;
+        for (int i = 7; i >= 0; --i)
+            padded.push_back(char(bits >> (8 * i)));
+        return padded;
+    }
+
+    // Hashes up to kLanes<V> messages side by side. Lanes whose message has
+    // fewer blocks keep their state once finished (masked select).
+    template <typename V>
+    SHA256_INLINE void hashGroup(const string *messages, size_t count, Digest *out)
+    {
+        const size_t lanes = kLanes<V>;
+        string padded[lanes];
+        size_t blocks[lanes] = {};
+        size_t maxBlocks = 0;
+        for (size_t l = 0; l < count; ++l)
+        {
+            padded[l] = pad(messages[l]);
+            blocks[l] = padded[l].size() / 64;
+            maxBlocks = max(maxBlocks, blocks[l]);
+        }
+
+        V state[8];
+        for (int i = 0; i < 8; ++i)
+            for (size_t l = 0; l < lanes; ++l)
+                setLane(state[i], l, H0[i]);
+
+        for (size_t b = 0; b < maxBlocks; ++b)
+        {
+            V w[64], active;
+            for (size_t l = 0; l < lanes; ++l)
+            {
+                bool live = l < count && b < blocks[l];
+                setLane(active, l, live ? 0xFFFFFFFFu : 0u);
+                const unsigned char *p = live ? reinterpret_cast<const unsigned char *>(padded[l].data()) + 64 * b : nullptr;
+                for (int j = 0; j < 16; ++j)
+                    setLane(w[j], l, p ? uint32_t(p[4 * j]) << 24 | uint32_t(p[4 * j + 1]) << 16 | uint32_t(p[4 * j + 2]) << 8 | p[4 * j + 3] : 0u);
+            }
+            for (int j = 16; j < 64; ++j)
+            {
+                V s0 = SHA256_ROTR(w[j - 15], 7) ^ SHA256_ROTR(w[j - 15], 18) ^ (w[j - 15] >> 3);
+                V s1 = SHA256_ROTR(w[j - 2], 17) ^ SHA256_ROTR(w[j - 2], 19) ^ (w[j - 2] >> 10);
+                w[j] = w[j - 16] + s0 + w[j - 7] + s1;
+            }
+            V a = state[0], bb = state[1], c = state[2], d = state[3];
+            V e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int j = 0; j < 64; ++j)
+            {
+                V t1 = h + (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[j] + w[j];
+                V t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) + ((a & bb) ^ (a & c) ^ (bb & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = bb;
+                bb = a;
+                a = t1 + t2;
+            }
+            V next[8] = {a, bb, c, d, e, f, g, h};
+            for (int i = 0; i < 8; ++i)
+                state[i] = ((state[i] + next[i]) & active) | (state[i] & ~active);
+        }
+
+        for (size_t l = 0; l < count; ++l)
+            for (int i = 0; i < 8; ++i)
+            {
+                uint32_t word = getLane(state[i], l);
+                for (int k = 0; k < 4; ++k)
+                    out[l][4 * i + k] = uint8_t(word >> (24 - 8 * k));
+            }
+    }
+
+    template <typename V>
+    SHA256_INLINE void hashAll(const string *messages, size_t count, Digest *out)
+    {
+        for (size_t i = 0; i < count; i += kLanes<V>)
+            hashGroup<V>(messages + i, min(kLanes<V>, count - i), out + i);
+    }
+
+    inline void hashScalar(const string *messages, size_t count, Digest *out)
+    {
+        hashAll<uint32_t>(messages, count, out);
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_HAS_X86_LANES 1
+    typedef uint32_t Lanes8 __attribute__((vector_size(32)));
+    typedef uint32_t Lanes16 __attribute__((vector_size(64)));
+
+    __attribute__((target("avx2"))) inline void hashAvx2(const string *messages, size_t count, Digest *out)
+    {
+        hashAll<Lanes8>(messages, count, out);
+    }
+    __attribute__((target("avx512f"))) inline void hashAvx512(const string *messages, size_t count, Digest *out)
+    {
+        hashAll<Lanes16>(messages, count, out);
+    }
+#endif
+}
+
+// Batched SHA-256 / HMAC-SHA-256 engine with runtime ISA selection
+class CredentialHasher
+{
+public:
+    enum class Isa
+    {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    static bool supported(Isa isa)
+    {
+#ifdef SHA256_HAS_X86_LANES
+        if (isa == Isa::Avx512)
+            return __builtin_cpu_supports("avx512f");
+        if (isa == Isa::Avx2)
+            return __builtin_cpu_supports("avx2");
+#endif
+        return isa == Isa::Scalar;
+    }
+    static Isa best()
+    {
+        for (Isa isa : {Isa::Avx512, Isa::Avx2})
+            if (supported(isa))
+                return isa;
+        return Isa::Scalar;
+    }
+    static const char *name(Isa isa)
+    {
+        return isa == Isa::Avx512 ? "avx512" : isa == Isa::Avx2 ? "avx2" : "scalar";
+    }
+
+    explicit CredentialHasher(Isa isa = best()) : isa(supported(isa) ? isa : Isa::Scalar) {}
+    Isa level() const { return isa; }
+
+    // A lane group costs about as much as two scalar hashes however many lanes
+    // are live, so a lone leftover message (e.g. a single login) is hashed scalar.
+    static const size_t kMinVectorGroup = 2;
+
+    // How many of `count` messages go through the SIMD lanes; the rest are scalar
+    size_t vectorCount(size_t count) const
+    {
+        if (isa == Isa::Scalar)
+            return 0;
+        size_t lanes = isa == Isa::Avx512 ? 16 : 8;
+        return count % lanes < kMinVectorGroup ? count - count % lanes : count;
+    }
+
+    vector<Digest> sha256(const vector<string> &messages) const
+    {
+        vector<Digest> out(messages.size());
+        size_t count = messages.size();
+        size_t vectored = vectorCount(count);
+        switch (isa)
+        {
+#ifdef SHA256_HAS_X86_LANES
+        case Isa::Avx512:
+            sha256::hashAvx512(messages.data(), vectored, out.data());
+            break;
+        case Isa::Avx2:
+            sha256::hashAvx2(messages.data(), vectored, out.data());
+            break;
+#endif
+        default:
+            vectored = 0;
+        }
+        sha256::hashScalar(messages.data() + vectored, count - vectored, out.data() + vectored);
+        return out;
+    }
+
+    // HMAC (RFC 2104): the inner and outer hashes each run as one batch
+    vector<Digest> hmac(const string &key, const vector<string> &messages) const
+    {
+        string block = key.size() > 64 ? digestBytes(sha256({key})[0]) : key;
+        block.resize(64, '\0');
+        string ipad = block, opad = block;
+        for (size_t i = 0; i < 64; ++i)
+        {
+            ipad[i] ^= 0x36;
+            opad[i] ^= 0x5c;
+        }
+        vector<string> inner;
+        inner.reserve(messages.size());
+        for (const auto &m : messages)
+            inner.push_back(ipad + m);
+        vector<Digest> innerDigests = sha256(inner);
+
+        vector<string> outer;
+        outer.reserve(messages.size());
+        for (const auto &d : innerDigests)
+            outer.push_back(opad + digestBytes(d));
+        return sha256(outer);
+    }
+
+    static string hex(const Digest &d)
+    {
+        static const char digits[] = "0123456789abcdef";
+        string s;
+        for (uint8_t byte : d)
+        {
+            s += digits[byte >> 4];
+            s += digits[byte & 0xF];
+        }
+        return s;
+    }
+
+private:
+    Isa isa;
+    static string digestBytes(const Digest &d) { return string(d.begin(), d.end()); }
+};
+
+struct Credentials
+{
+    string username, password;
+};
+
+// Target interface: token derivation is a batchable step of its own
+class IAuthProvider
+{
+public:
+    virtual bool login(const string &username, const string &password) = 0;
+    virtual vector<string> deriveTokens(const vector<Credentials> &batch) const = 0;
+    virtual ~IAuthProvider() = default;
+};
+
+// Adaptees (third-party APIs, unchanged)
+class GoogleLoginAPI
+{
+public:
+    bool googleSignIn(const string &oauthToken)
+    {
+        OutputSink::getInstance().write("[GoogleLoginAPI] Signing in with token: ", oauthToken);
+        return !oauthToken.empty();
+    }
+};
+
+class XLoginAPI
+{
+public:
+    bool XSignIn(const string &secretToken)
+    {
+        OutputSink::getInstance().write("[TwitterLoginAPI] Signing In with secretToken : ", secretToken);
+        return !secretToken.empty();
+    }
+};
+
+// Shared token derivation: HMAC over "username:password" with a per-provider key
+class HashingAuthProvider : public IAuthProvider
+{
+    const CredentialHasher &hasher;
+    string providerKey;
+
+public:
+    HashingAuthProvider(const CredentialHasher &hasher, string providerKey)
+        : hasher(hasher), providerKey(move(providerKey)) {}
+
+    vector<string> deriveTokens(const vector<Credentials> &batch) const override
+    {
+        vector<string> messages;
+        messages.reserve(batch.size());
+        for (const auto &c : batch)
+            messages.push_back(c.username + ":" + c.password);
+        vector<string> tokens;
+        tokens.reserve(batch.size());
+        for (const auto &d : hasher.hmac(providerKey, messages))
+            tokens.push_back(CredentialHasher::hex(d));
+        return tokens;
+    }
+
+protected:
+    string deriveToken(const string &username, const string &password) const
+    {
+        return deriveTokens({{username, password}})[0];
+    }
+};
+
+class GoogleAdapter : public HashingAuthProvider
+{
+    GoogleLoginAPI googleApi;
+
+public:
+    explicit GoogleAdapter(const CredentialHasher &hasher) : HashingAuthProvider(hasher, "google-oauth-key") {}
+    bool login(const string &username, const string &password) override
+    {
+        return googleApi.googleSignIn(deriveToken(username, password));
+    }
+};
+
+class XAdapter : public HashingAuthProvider
+{
+    XLoginAPI xloginapi;
+
+public:
+    explicit XAdapter(const CredentialHasher &hasher) : HashingAuthProvider(hasher, "x-secret-key") {}
+    bool login(const string &username, const string &password) override
+    {
+        return xloginapi.XSignIn(deriveToken(username, password));
+    }
+};
+
+// Known-answer tests (FIPS 180-2 and RFC 4231 test case 2) for one ISA level
+void checkKnownAnswers(const CredentialHasher &hasher)
+{
+    vector<string> messages = {"", "abc", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"};
+    vector<Digest> d = hasher.sha256(messages);
+    assert(CredentialHasher::hex(d[0]) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(CredentialHasher::hex(d[1]) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    assert(CredentialHasher::hex(d[2]) == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    assert(CredentialHasher::hex(hasher.hmac("Jefe", {"what do ya want for nothing?"})[0]) ==
+           "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    // Every lane of a mixed-length batch must agree with the scalar path,
+    // including batches whose last message is hashed scalar
+    for (size_t size : {1, 17, 37})
+    {
+        vector<string> mixed;
+        for (size_t i = 0; i < size; ++i)
+            mixed.push_back(string(i * 5, char('a' + i % 26)));
+        assert(hasher.sha256(mixed) == CredentialHasher(CredentialHasher::Isa::Scalar).sha256(mixed));
+    }
+}
+
+int main()
+{
+    CredentialHasher hasher;
+    cout << "Selected ISA: " << CredentialHasher::name(hasher.level()) << "\n";
+
+    GoogleAdapter googleAuth(hasher);
+    XAdapter xAuth(hasher);
+    googleAuth.login("alice@gmail.com", "password123");
+    xAuth.login("bob@gmail.com", "abc123");
+    OutputSink::getInstance().flush(); // keep the sign-ins ahead of the results
+
+    vector<Credentials> batch;
+    for (int i = 0; i < 200000; ++i)
+        batch.push_back({"user" + to_string(i) + "@example.com", "pw" + to_string(i * 7919)});
+
+    for (auto isa : {CredentialHasher::Isa::Scalar, CredentialHasher::Isa::Avx2, CredentialHasher::Isa::Avx512})
+    {
+        if (!CredentialHasher::supported(isa))
+        {
+            cout << CredentialHasher::name(isa) << ": not supported on this CPU\n";
+            continue;
+        }
+        CredentialHasher levelHasher(isa);
+        checkKnownAnswers(levelHasher);
+        GoogleAdapter adapter(levelHasher);
+        auto start = chrono::steady_clock::now();
+        vector<string> tokens = adapter.deriveTokens(batch);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << CredentialHasher::name(isa) << ": known answers ok, "
+             << size_t(tokens.size() / seconds) << " HMAC tokens/sec\n";
+    }
+
+    // A single login must not pay for a whole lane group: it takes the scalar path
+    assert(hasher.vectorCount(1) == 0);
+    auto loginNanos = [](const CredentialHasher &levelHasher) {
+        GoogleAdapter adapter(levelHasher);
+        adapter.deriveTokens({{"alice@gmail.com", "password123"}}); // warm up
+        double best = 1e30;
+        for (int round = 0; round < 5; ++round)
+        {
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < 20000; ++i)
+                adapter.deriveTokens({{"alice@gmail.com", "password123"}});
+            best = min(best, chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / 20000);
+        }
+        return best;
+    };
+    double scalarLogin = loginNanos(CredentialHasher(CredentialHasher::Isa::Scalar));
+    double selectedLogin = loginNanos(hasher);
+    cout << "single login: scalar " << size_t(scalarLogin) << " ns, " << CredentialHasher::name(hasher.level())
+         << " " << size_t(selectedLogin) << " ns\n";
+    return 0;
+}
+
+/*
+Output (ISA support and rates vary by machine):
+Selected ISA: avx512
+[GoogleLoginAPI] Signing in with token: <64 hex digits>
+[TwitterLoginAPI] Signing In with secretToken : <64 hex digits>
+scalar: known answers ok, 430000 HMAC tokens/sec
+avx2: known answers ok, 780000 HMAC tokens/sec
+avx512: known answers ok, 1050000 HMAC tokens/sec
+single login: scalar 1750 ns, avx512 1760 ns
+*/
+// Providers never see raw credentials, and the hashing cost is shared across a whole batch of logins.
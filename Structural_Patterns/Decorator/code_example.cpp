@@ -94,3 +94,1255 @@ int main()
 
     return 0;
 }
+
+// ========== Decorators Registering in an Inverted Tag Index ==========
+// Tags and features are also recorded as structured terms: each decorator adds
+// its post's ID to the term's posting list, so "which posts have #summer and
+// are pinned?" is answered without rendering any post.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Sorted post IDs stored as delta-encoded varints (1 byte for gaps under 128).
+// Every kSkipInterval IDs a skip entry records where a block starts, so a
+// Cursor can jump over whole blocks instead of decoding them.
+// IDs normally arrive in increasing order; an out-of-order ID is kept in a small
+// sorted pending list, and once that list passes a threshold it is merged back
+// into the encoded bytes.
+class PostingList
+{
+    static const std::size_t kSkipInterval = 128;
+
+    struct Skip
+    {
+        std::uint32_t base;   // ID before the block (gaps are added to it)
+        std::uint32_t offset; // byte offset of the block's first gap
+    };
+
+    std::vector<std::uint8_t> bytes;
+    std::vector<Skip> skips;
+    std::vector<std::uint32_t> pending;
+    std::uint32_t last = 0;
+    std::size_t count = 0;
+
+    void append(std::uint32_t postId)
+    {
+        if (count % kSkipInterval == 0)
+            skips.push_back({last, std::uint32_t(bytes.size())});
+        std::uint32_t gap = postId - last; // the first ID is a gap from 0
+        while (gap >= 0x80)
+        {
+            bytes.push_back(std::uint8_t(gap | 0x80));
+            gap >>= 7;
+        }
+        bytes.push_back(std::uint8_t(gap));
+        last = postId;
+        ++count;
+    }
+
+    // Re-encode with the pending IDs merged in
+    void compact()
+    {
+        std::vector<std::uint32_t> ids = decode();
+        bytes.clear();
+        skips.clear();
+        pending.clear();
+        last = 0;
+        count = 0;
+        for (std::uint32_t id : ids)
+            append(id);
+    }
+
+public:
+    // Forward-only reader over the encoded IDs (not the pending list).
+    // Targets passed to seek() must be non-decreasing.
+    class Cursor
+    {
+        const PostingList &list;
+        std::size_t pos = 0, nextSkip = 0;
+        std::uint32_t id = 0;
+        bool atId = false;
+
+    public:
+        explicit Cursor(const PostingList &list) : list(list) {}
+
+        // True if `target` is in the encoded IDs
+        bool seek(std::uint32_t target)
+        {
+            if (atId && id >= target)
+                return id == target;
+            // Jump to the last block that starts before `target`
+            auto first = list.skips.begin() + nextSkip;
+            auto it = std::partition_point(first, list.skips.end(), [&](const Skip &s) { return s.base < target; });
+            if (it != first)
+            {
+                const Skip &skip = *(it - 1);
+                nextSkip = std::size_t(it - list.skips.begin());
+                if (skip.offset > pos)
+                {
+                    pos = skip.offset;
+                    id = skip.base;
+                    atId = false;
+                }
+            }
+            while ((!atId || id < target) && pos < list.bytes.size())
+            {
+                std::uint32_t gap = 0;
+                int shift = 0;
+                std::uint8_t b;
+                do
+                {
+                    b = list.bytes[pos++];
+                    gap |= std::uint32_t(b & 0x7F) << shift;
+                    shift += 7;
+                } while (b & 0x80);
+                id += gap;
+                atId = true;
+            }
+            return atId && id == target;
+        }
+    };
+
+    void add(std::uint32_t postId)
+    {
+        if (count == 0 || postId > last)
+        {
+            append(postId);
+            return;
+        }
+        if (Cursor(*this).seek(postId))
+            return;
+        auto it = std::lower_bound(pending.begin(), pending.end(), postId);
+        if (it != pending.end() && *it == postId)
+            return;
+        pending.insert(it, postId);
+        if (pending.size() > 64 + count / 16)
+            compact();
+    }
+
+    bool pendingContains(std::uint32_t postId) const
+    {
+        return std::binary_search(pending.begin(), pending.end(), postId);
+    }
+
+    std::vector<std::uint32_t> decode() const
+    {
+        std::vector<std::uint32_t> ids;
+        ids.reserve(count + pending.size());
+        std::uint32_t id = 0, gap = 0;
+        int shift = 0;
+        for (std::uint8_t b : bytes)
+        {
+            gap |= std::uint32_t(b & 0x7F) << shift;
+            shift += 7;
+            if (!(b & 0x80))
+            {
+                id += gap;
+                ids.push_back(id);
+                gap = 0;
+                shift = 0;
+            }
+        }
+        if (!pending.empty())
+        {
+            std::size_t encoded = ids.size();
+            ids.insert(ids.end(), pending.begin(), pending.end());
+            std::inplace_merge(ids.begin(), ids.begin() + encoded, ids.end());
+        }
+        return ids;
+    }
+
+    std::size_t size() const { return count + pending.size(); }
+    std::size_t memoryBytes() const
+    {
+        return bytes.capacity() + skips.capacity() * sizeof(Skip) + pending.capacity() * sizeof(std::uint32_t);
+    }
+};
+
+// Term ("#summer", "Pinned") -> term ID -> posting list
+class PostIndex
+{
+    std::unordered_map<std::string, std::uint32_t> termIds;
+    std::vector<PostingList> postings;
+
+    const PostingList *find(const std::string &term) const
+    {
+        auto it = termIds.find(term);
+        return it == termIds.end() ? nullptr : &postings[it->second];
+    }
+
+public:
+    void add(const std::string &term, std::uint32_t postId)
+    {
+        auto it = termIds.emplace(term, std::uint32_t(postings.size())).first;
+        if (it->second == postings.size())
+            postings.emplace_back();
+        postings[it->second].add(postId);
+    }
+
+    // Posts carrying every term: the smallest list is decoded, and each of its
+    // IDs is looked up in the larger lists with skip-pointer cursors
+    std::vector<std::uint32_t> all(std::vector<std::string> terms) const
+    {
+        std::vector<const PostingList *> lists;
+        for (const auto &t : terms)
+        {
+            const PostingList *list = find(t);
+            if (!list)
+                return {};
+            lists.push_back(list);
+        }
+        if (lists.empty())
+            return {};
+        std::sort(lists.begin(), lists.end(),
+                  [](const PostingList *a, const PostingList *b) { return a->size() < b->size(); });
+        std::vector<std::uint32_t> result = lists[0]->decode();
+        for (std::size_t i = 1; i < lists.size() && !result.empty(); ++i)
+        {
+            PostingList::Cursor cursor(*lists[i]);
+            std::size_t kept = 0;
+            for (std::uint32_t id : result)
+                if (cursor.seek(id) || lists[i]->pendingContains(id))
+                    result[kept++] = id;
+            result.resize(kept);
+        }
+        return result;
+    }
+
+    // Posts carrying at least one of the terms
+    std::vector<std::uint32_t> any(const std::vector<std::string> &terms) const
+    {
+        std::vector<std::uint32_t> result;
+        for (const auto &t : terms)
+        {
+            const PostingList *list = find(t);
+            if (!list)
+                continue;
+            std::vector<std::uint32_t> next = list->decode(), merged;
+            std::set_union(result.begin(), result.end(), next.begin(), next.end(), std::back_inserter(merged));
+            result.swap(merged);
+        }
+        return result;
+    }
+
+    std::size_t memoryBytes() const
+    {
+        std::size_t total = 0;
+        for (const auto &p : postings)
+            total += p.memoryBytes();
+        return total;
+    }
+};
+
+// Base Post class (now with an identity the index can refer to)
+class Post
+{
+public:
+    virtual std::string getContent() const = 0;
+    virtual std::uint32_t getId() const = 0;
+    virtual ~Post() {}
+};
+
+class BasicPost : public Post
+{
+    std::uint32_t id;
+    std::string text;
+
+public:
+    BasicPost(std::uint32_t id, const std::string &text) : id(id), text(text) {}
+    std::string getContent() const override { return text; }
+    std::uint32_t getId() const override { return id; }
+};
+
+// Decorator base class
+class PostDecorator : public Post
+{
+protected:
+    Post *post;
+
+public:
+    PostDecorator(Post *p) : post(p) {}
+    std::uint32_t getId() const override { return post->getId(); }
+    virtual ~PostDecorator() { delete post; }
+};
+
+class TagDecorator : public PostDecorator
+{
+    std::string tag;
+
+public:
+    TagDecorator(Post *p, const std::string &tag, PostIndex &index) : PostDecorator(p), tag(tag)
+    {
+        index.add("#" + tag, getId());
+    }
+    std::string getContent() const override
+    {
+        return post->getContent() + " [#" + tag + "]";
+    }
+};
+
+class FeatureDecorator : public PostDecorator
+{
+public:
+    FeatureDecorator(Post *p, PostIndex &index) : PostDecorator(p)
+    {
+        index.add("Pinned", getId());
+    }
+    std::string getContent() const override
+    {
+        return post->getContent() + " [Pinned]";
+    }
+};
+
+void printIds(const std::string &label, const std::vector<std::uint32_t> &ids)
+{
+    std::cout << label << ":";
+    for (std::uint32_t id : ids)
+        std::cout << " " << id;
+    std::cout << "\n";
+}
+
+template <typename F>
+double microsecondsFor(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage
+int main()
+{
+    PostIndex index;
+    std::vector<Post *> posts;
+    posts.push_back(new FeatureDecorator(new TagDecorator(new BasicPost(1, "Hello, world!"), "summer", index), index));
+    posts.push_back(new TagDecorator(new BasicPost(2, "Beach day"), "summer", index));
+    posts.push_back(new TagDecorator(new TagDecorator(new BasicPost(3, "Road trip"), "travel", index), "summer", index));
+    posts.push_back(new FeatureDecorator(new BasicPost(4, "Welcome"), index));
+
+    for (Post *p : posts)
+        std::cout << p->getId() << ": " << p->getContent() << std::endl;
+    printIds("#summer AND Pinned", index.all({"#summer", "Pinned"}));
+    printIds("#travel OR Pinned ", index.any({"#travel", "Pinned"}));
+    for (Post *p : posts)
+        delete p;
+
+    // Index scale test: 10M posts, terms registered as decorators would
+    const std::uint32_t kPosts = 10'000'000;
+    PostIndex big;
+    std::size_t plainBytes = 0;
+    for (std::uint32_t id = 0; id < kPosts; ++id)
+    {
+        if (id % 3 == 0)
+            big.add("#summer", id), plainBytes += 4;
+        if (id % 5 == 0)
+            big.add("#travel", id), plainBytes += 4;
+        if (id % 100 == 0)
+            big.add("Pinned", id), plainBytes += 4;
+        if ((id * 2654435761u) % 10 == 0)
+            big.add("#food", id), plainBytes += 4;
+    }
+
+    std::size_t hits = 0;
+    double andUs = microsecondsFor([&] { hits = big.all({"#summer", "Pinned"}).size(); });
+    std::cout << "10M posts, #summer AND Pinned: " << hits << " hits in " << std::size_t(andUs) << " us\n";
+    double orUs = microsecondsFor([&] { hits = big.any({"#travel", "#food"}).size(); });
+    std::cout << "10M posts, #travel OR #food: " << hits << " hits in " << std::size_t(orUs) << " us\n";
+    std::cout << "Index memory: " << big.memoryBytes() / (1024 * 1024) << " MiB (plain uint32 lists: "
+              << plainBytes / (1024 * 1024) << " MiB)\n";
+
+    // Out-of-order registration: IDs arrive in shuffled blocks, so most go
+    // through the pending list and get merged back into the encoded bytes
+    PostIndex shuffled;
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t block = 0; block < 100; ++block)
+    {
+        std::uint32_t start = (block * 37) % 100 * 1000;
+        for (std::uint32_t id = start; id < start + 1000; ++id)
+        {
+            if (id % 3 == 0)
+                shuffled.add("#summer", id);
+            if (id % 7 == 0)
+                shuffled.add("Pinned", id);
+        }
+    }
+    for (std::uint32_t id = 0; id < 100'000; id += 21)
+        expected.push_back(id);
+    bool same = shuffled.all({"#summer", "Pinned"}) == expected;
+    std::cout << "Shuffled registration, #summer AND Pinned matches: " << (same ? "yes" : "no") << "\n";
+    return same ? 0 : 1;
+}
+
+/*
+Output (timings vary by machine):
+1: Hello, world! [#summer] [Pinned]
+2: Beach day [#summer]
+3: Road trip [#travel] [#summer]
+4: Welcome [Pinned]
+#summer AND Pinned: 1
+#travel OR Pinned : 1 3 4
+10M posts, #summer AND Pinned: 33334 hits in 12000 us
+10M posts, #travel OR #food: 2799998 hits in 35000 us
+Index memory: 7 MiB (plain uint32 lists: 24 MiB)
+Shuffled registration, #summer AND Pinned matches: yes
+*/
+// Queries run over compact ID lists; rendering (getContent) is only needed for the posts actually shown.
+
+// ========== Recording Decorators: Trace Record and Replay ==========
+// The same wrapping idea applied to the service interfaces from the other
+// examples (OrderCreator, MealFactory, SandwichBuilder, IAuthProvider).
+// Each recording decorator forwards the call and appends a small timestamped
+// binary record to a per-thread buffer. Traces can be saved to a file and loaded
+// back, and a replayer re-drives the captured calls at original speed, at full
+// speed, or spread over N threads, and prints latency histograms.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <singleton/singleton_use_case_hot_path_instrumentation.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ---- Services (trimmed versions of the other examples; text is returned, not printed) ----
+
+class Order
+{
+public:
+    virtual std::string describe() const = 0;
+    virtual ~Order() = default;
+};
+class DeliveryOrder : public Order
+{
+public:
+    std::string describe() const override { return "Delivery Order"; }
+};
+class DineInOrder : public Order
+{
+public:
+    std::string describe() const override { return "Dine-In Order"; }
+};
+class OrderCreator
+{
+public:
+    virtual std::unique_ptr<Order> createOrder() const = 0;
+    virtual std::uint8_t kind() const = 0; // stable code used in traces
+    virtual ~OrderCreator() = default;
+};
+class DeliveryOrderCreator : public OrderCreator
+{
+public:
+    std::unique_ptr<Order> createOrder() const override { return std::make_unique<DeliveryOrder>(); }
+    std::uint8_t kind() const override { return 0; }
+};
+class DineInOrderCreator : public OrderCreator
+{
+public:
+    std::unique_ptr<Order> createOrder() const override { return std::make_unique<DineInOrder>(); }
+    std::uint8_t kind() const override { return 1; }
+};
+
+class MealFactory
+{
+public:
+    virtual std::string assemble() const = 0; // main + side + drink
+    virtual std::uint8_t kind() const = 0;
+    virtual ~MealFactory() = default;
+};
+class VegMealFactory : public MealFactory
+{
+public:
+    std::string assemble() const override { return "Paneer, Salad, Juice"; }
+    std::uint8_t kind() const override { return 0; }
+};
+class NonVegMealFactory : public MealFactory
+{
+public:
+    std::string assemble() const override { return "Chicken, Fries, Soda"; }
+    std::uint8_t kind() const override { return 1; }
+};
+
+class Sandwich
+{
+    std::string bread, filling, sauce, extras;
+
+public:
+    Sandwich(const std::string &bread, const std::string &filling, const std::string &sauce, const std::string &extras)
+        : bread(bread), filling(filling), sauce(sauce), extras(extras) {}
+    std::string describe() const
+    {
+        return "Sandwich: " + bread + ", " + filling + ", " + sauce + ", Extras: " + extras;
+    }
+};
+
+// Same step interface as the Builder example
+class SandwichBuilder
+{
+protected:
+    std::string bread, filling, sauce, extras;
+
+public:
+    virtual SandwichBuilder &addBread(const std::string &b) = 0;
+    virtual SandwichBuilder &addFilling(const std::string &f) = 0;
+    virtual SandwichBuilder &addSauce(const std::string &s) = 0;
+    virtual SandwichBuilder &addExtras(const std::string &e) = 0;
+    virtual std::unique_ptr<Sandwich> build() = 0;
+    virtual ~SandwichBuilder() = default;
+};
+class VegSandwichBuilder : public SandwichBuilder
+{
+public:
+    SandwichBuilder &addBread(const std::string &b) override { bread = b; return *this; }
+    SandwichBuilder &addFilling(const std::string &f) override { filling = f; return *this; }
+    SandwichBuilder &addSauce(const std::string &s) override { sauce = s; return *this; }
+    SandwichBuilder &addExtras(const std::string &e) override { extras = e; return *this; }
+    std::unique_ptr<Sandwich> build() override { return std::make_unique<Sandwich>(bread, filling, sauce, extras); }
+};
+
+class IAuthProvider
+{
+public:
+    virtual bool login(const std::string &username, const std::string &password) = 0;
+    virtual std::uint8_t kind() const = 0;
+    virtual ~IAuthProvider() = default;
+};
+class GoogleAdapter : public IAuthProvider
+{
+public:
+    bool login(const std::string &username, const std::string &password) override
+    {
+        return !(username + ":" + password).empty();
+    }
+    std::uint8_t kind() const override { return 0; }
+};
+
+// A provider behind a local socket, like the Adapter example's pooled sessions:
+// every login is one request/response round trip to another thread
+class SocketAuthProvider : public IAuthProvider
+{
+    int fds[2] = {-1, -1};
+    std::thread responder;
+
+public:
+    SocketAuthProvider()
+    {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            throw std::runtime_error("cannot create a socket pair");
+        responder = std::thread([fd = fds[1]] {
+            char request[512];
+            while (recv(fd, request, sizeof(request), 0) > 0)
+            {
+                char reply = '1';
+                send(fd, &reply, 1, MSG_NOSIGNAL);
+            }
+        });
+    }
+    ~SocketAuthProvider()
+    {
+        shutdown(fds[0], SHUT_RDWR); // ends the responder's recv loop
+        responder.join();
+        close(fds[0]);
+        close(fds[1]);
+    }
+    bool login(const std::string &username, const std::string &password) override
+    {
+        std::string token = username + ":" + password;
+        char reply = '0';
+        return send(fds[0], token.data(), token.size(), MSG_NOSIGNAL) == ssize_t(token.size()) &&
+               recv(fds[0], &reply, 1, 0) == 1 && reply == '1';
+    }
+    std::uint8_t kind() const override { return 1; }
+};
+
+// ---- Trace format ----
+// file   : "DPTRACE" version(u8), then records
+// record : timestamp(u64 ns since recording start; raw ticks until finish()) call(u8) variant(u8) fieldCount(u8)
+//          fieldCount x [length(u16) bytes...]
+// variant is the creator/factory/provider kind; for buildSandwich it is a mask
+// of the steps (bit 0 bread .. bit 3 extras) called before build().
+
+enum class Call : std::uint8_t
+{
+    PlaceOrder,
+    AssembleMeal,
+    BuildSandwich,
+    Login,
+    Count
+};
+const char *callName(Call c)
+{
+    static const char *names[] = {"placeOrder", "assembleMeal", "buildSandwich", "login"};
+    return names[std::size_t(c)];
+}
+const std::uint8_t kFieldCounts[] = {0, 0, 4, 2}; // per Call, checked when a trace is parsed
+
+// Raw timestamp source for records. On x86 the TSC is read directly (a few ns);
+// elsewhere steady_clock is used. finish() converts raw ticks to nanoseconds.
+inline std::uint64_t traceTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+class TraceRecorder
+{
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kChunkBytes = 1 << 20;
+
+    // One per (thread, recorder). Records are written straight into the current
+    // chunk and never straddle two chunks; full chunks are kept until finish().
+    struct ThreadBuffer
+    {
+        std::vector<std::pair<std::unique_ptr<char[]>, std::size_t>> chunks; // data, bytes used
+        char *cursor = nullptr, *end = nullptr;
+
+        char *reserve(std::size_t size)
+        {
+            if (std::size_t(end - cursor) < size)
+            {
+                if (!chunks.empty())
+                    chunks.back().second = cursor - chunks.back().first.get();
+                std::size_t bytes = std::max(kChunkBytes, size);
+                chunks.emplace_back(std::unique_ptr<char[]>(new char[bytes]), 0);
+                cursor = chunks.back().first.get();
+                end = cursor + bytes;
+            }
+            char *p = cursor;
+            cursor += size;
+            return p;
+        }
+    };
+    // Most recently used first, so a thread alternating between a few recorders
+    // finds its buffer without a lock; a miss looks the thread up in `buffers`
+    using BufferCache = std::array<std::pair<std::uint64_t, ThreadBuffer *>, 8>;
+
+    Clock::time_point start = Clock::now();
+    std::uint64_t startTicks = traceTicks();
+    std::mutex buffersMutex; // only taken on a cache miss
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers; // one per thread
+    std::atomic<bool> enabled{true};
+    // Unique per recorder, so a thread's cached buffer is never reused by a
+    // later recorder that happens to live at the same address
+    std::uint64_t id = nextId()++;
+
+    static std::atomic<std::uint64_t> &nextId()
+    {
+        static std::atomic<std::uint64_t> counter{1};
+        return counter;
+    }
+
+    ThreadBuffer &localBuffer()
+    {
+        thread_local BufferCache cache{};
+        if (cache[0].first == id)
+            return *cache[0].second;
+        return findBuffer(cache);
+    }
+
+    ThreadBuffer &findBuffer(BufferCache &cache)
+    {
+        auto it = std::find_if(cache.begin(), cache.end(), [&](const auto &entry) { return entry.first == id; });
+        ThreadBuffer *buffer;
+        if (it != cache.end())
+            buffer = it->second;
+        else
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            auto &owned = buffers[std::this_thread::get_id()];
+            if (!owned)
+                owned = std::make_unique<ThreadBuffer>();
+            buffer = owned.get();
+            it = cache.end() - 1; // evict the least recently used entry
+        }
+        std::rotate(cache.begin(), it, it + 1);
+        cache[0] = {id, buffer};
+        return *buffer;
+    }
+
+    static std::size_t fieldSize(std::string_view f) { return 2 + std::min<std::size_t>(f.size(), 0xFFFF); }
+    static void putField(char *&p, std::string_view f)
+    {
+        std::uint16_t len = std::uint16_t(std::min<std::size_t>(f.size(), 0xFFFF));
+        std::memcpy(p, &len, sizeof(len));
+        std::memcpy(p + 2, f.data(), len);
+        p += 2 + len;
+    }
+
+public:
+    // Fields are anything convertible to std::string_view; the record's size is
+    // known up front, so it is copied once into space reserved in the chunk.
+    template <typename... Fields>
+    void record(Call call, std::uint8_t variant, const Fields &...fields)
+    {
+        static_assert(sizeof...(Fields) < 256, "field count is stored in one byte");
+        if (!enabled.load(std::memory_order_relaxed))
+            return;
+        std::uint64_t ticks = traceTicks() - startTicks;
+        std::size_t size = 11 + (std::size_t(0) + ... + fieldSize(fields));
+        char *p = localBuffer().reserve(size);
+        std::memcpy(p, &ticks, sizeof(ticks));
+        p[8] = char(call);
+        p[9] = char(variant);
+        p[10] = char(sizeof...(Fields));
+        p += 11;
+        (putField(p, fields), ...);
+    }
+
+    // Stops recording and returns all threads' records merged in time order.
+    // Call once the recorded threads have finished.
+    std::string finish();
+};
+
+struct TraceEvent
+{
+    std::uint64_t ns;
+    Call call;
+    std::uint8_t variant;
+    std::vector<std::string_view> fields; // views into the trace buffer
+    std::string_view bytes;               // the whole record
+};
+
+// Parses trace records; the events refer into `trace`, which must outlive them.
+// Traces may come from files, so every length is checked.
+std::vector<TraceEvent> parseTrace(std::string_view trace)
+{
+    std::vector<TraceEvent> events;
+    std::size_t pos = 0;
+    auto need = [&](std::size_t n) {
+        if (trace.size() - pos < n)
+            throw std::runtime_error("truncated trace record");
+    };
+    while (pos < trace.size())
+    {
+        std::size_t begin = pos;
+        need(11);
+        TraceEvent e;
+        std::memcpy(&e.ns, trace.data() + pos, sizeof(e.ns));
+        e.call = Call(trace[pos + 8]);
+        e.variant = std::uint8_t(trace[pos + 9]);
+        std::uint8_t count = std::uint8_t(trace[pos + 10]);
+        pos += 11;
+        if (e.call >= Call::Count || count != kFieldCounts[std::size_t(e.call)])
+            throw std::runtime_error("malformed trace record");
+        for (std::uint8_t i = 0; i < count; ++i)
+        {
+            need(2);
+            std::uint16_t len;
+            std::memcpy(&len, trace.data() + pos, sizeof(len));
+            pos += 2;
+            need(len);
+            e.fields.push_back(trace.substr(pos, len));
+            pos += len;
+        }
+        e.bytes = trace.substr(begin, pos - begin);
+        events.push_back(std::move(e));
+    }
+    return events;
+}
+
+std::string TraceRecorder::finish()
+{
+    enabled.store(false);
+    double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    double nsPerTick = elapsedNs / double(std::max<std::uint64_t>(traceTicks() - startTicks, 1));
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    // Each thread's chunks are already in time order; merge them by timestamp
+    std::vector<TraceEvent> events;
+    for (const auto &[owner, buffer] : buffers)
+    {
+        if (!buffer->chunks.empty())
+            buffer->chunks.back().second = buffer->cursor - buffer->chunks.back().first.get();
+        for (const auto &chunk : buffer->chunks)
+        {
+            std::vector<TraceEvent> parsed = parseTrace(std::string_view(chunk.first.get(), chunk.second));
+            std::move(parsed.begin(), parsed.end(), std::back_inserter(events));
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const auto &a, const auto &b) { return a.ns < b.ns; });
+    std::string merged;
+    std::size_t total = 0;
+    for (const auto &e : events)
+        total += e.bytes.size();
+    merged.reserve(total);
+    for (const auto &e : events)
+    {
+        std::uint64_t ns = std::uint64_t(double(e.ns) * nsPerTick);
+        merged.append(reinterpret_cast<const char *>(&ns), sizeof(ns));
+        merged.append(e.bytes.substr(sizeof(ns)));
+    }
+    return merged;
+}
+
+// ---- Trace files, so a trace captured in production can be replayed elsewhere ----
+
+const char kTraceMagic[7] = {'D', 'P', 'T', 'R', 'A', 'C', 'E'};
+const std::uint8_t kTraceVersion = 1;
+
+void saveTrace(const std::string &path, std::string_view trace)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(kTraceMagic, sizeof(kTraceMagic));
+    file.put(char(kTraceVersion));
+    file.write(trace.data(), std::streamsize(trace.size()));
+    if (!file.flush())
+        throw std::runtime_error("cannot write trace to " + path);
+}
+
+// Returns the records of a trace file; parseTrace() validates them
+std::string loadTrace(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("cannot open trace " + path);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (contents.size() < sizeof(kTraceMagic) + 1 || contents.compare(0, sizeof(kTraceMagic), kTraceMagic, sizeof(kTraceMagic)) != 0)
+        throw std::runtime_error(path + " is not a trace file");
+    if (std::uint8_t(contents[sizeof(kTraceMagic)]) != kTraceVersion)
+        throw std::runtime_error(path + ": unsupported trace version");
+    return contents.substr(sizeof(kTraceMagic) + 1);
+}
+
+// ---- Recording decorators: same interface, forward + record ----
+
+class RecordingOrderCreator : public OrderCreator
+{
+    const OrderCreator &inner;
+    TraceRecorder &trace;
+
+public:
+    RecordingOrderCreator(const OrderCreator &inner, TraceRecorder &trace) : inner(inner), trace(trace) {}
+    std::unique_ptr<Order> createOrder() const override
+    {
+        trace.record(Call::PlaceOrder, inner.kind());
+        return inner.createOrder();
+    }
+    std::uint8_t kind() const override { return inner.kind(); }
+};
+
+class RecordingMealFactory : public MealFactory
+{
+    const MealFactory &inner;
+    TraceRecorder &trace;
+
+public:
+    RecordingMealFactory(const MealFactory &inner, TraceRecorder &trace) : inner(inner), trace(trace) {}
+    std::string assemble() const override
+    {
+        trace.record(Call::AssembleMeal, inner.kind());
+        return inner.assemble();
+    }
+    std::uint8_t kind() const override { return inner.kind(); }
+};
+
+// Forwards each step and keeps its own copy (in the inherited fields), so one
+// record at build() captures the whole sandwich. Steps return the decorator,
+// so chained calls stay recorded.
+class RecordingSandwichBuilder : public SandwichBuilder
+{
+    SandwichBuilder &inner;
+    TraceRecorder &trace;
+    std::uint8_t steps = 0;
+
+public:
+    RecordingSandwichBuilder(SandwichBuilder &inner, TraceRecorder &trace) : inner(inner), trace(trace) {}
+    SandwichBuilder &addBread(const std::string &b) override
+    {
+        inner.addBread(b);
+        bread = b;
+        steps |= 1;
+        return *this;
+    }
+    SandwichBuilder &addFilling(const std::string &f) override
+    {
+        inner.addFilling(f);
+        filling = f;
+        steps |= 2;
+        return *this;
+    }
+    SandwichBuilder &addSauce(const std::string &s) override
+    {
+        inner.addSauce(s);
+        sauce = s;
+        steps |= 4;
+        return *this;
+    }
+    SandwichBuilder &addExtras(const std::string &e) override
+    {
+        inner.addExtras(e);
+        extras = e;
+        steps |= 8;
+        return *this;
+    }
+    std::unique_ptr<Sandwich> build() override
+    {
+        trace.record(Call::BuildSandwich, steps, bread, filling, sauce, extras);
+        steps = 0;
+        return inner.build();
+    }
+};
+
+// Passwords are never written to the trace; only their length is kept so
+// replayed logins do the same amount of work.
+class RecordingAuthProvider : public IAuthProvider
+{
+    IAuthProvider &inner;
+    TraceRecorder &trace;
+
+public:
+    RecordingAuthProvider(IAuthProvider &inner, TraceRecorder &trace) : inner(inner), trace(trace) {}
+    bool login(const std::string &username, const std::string &password) override
+    {
+        std::uint16_t len = std::uint16_t(password.size());
+        trace.record(Call::Login, inner.kind(), username,
+                     std::string_view(reinterpret_cast<const char *>(&len), sizeof(len)));
+        return inner.login(username, password);
+    }
+    std::uint8_t kind() const override { return inner.kind(); }
+};
+
+// ---- Replay ----
+
+std::atomic<std::size_t> workSink{0}; // keeps replayed work from being optimized away
+
+// The metrics registry's HDR-style histogram (Singleton example)
+using singleton::singleton_use_case_hot_path_instrumentation::LatencyHistogram;
+
+struct Services
+{
+    DeliveryOrderCreator delivery;
+    DineInOrderCreator dineIn;
+    VegMealFactory veg;
+    NonVegMealFactory nonVeg;
+    VegSandwichBuilder sandwiches;
+    GoogleAdapter google;
+
+    // Re-issues one recorded call; returns a value so the work isn't optimized away
+    std::size_t drive(const TraceEvent &e)
+    {
+        switch (e.call)
+        {
+        case Call::PlaceOrder:
+            return (e.variant == 0 ? static_cast<const OrderCreator &>(delivery) : dineIn).createOrder()->describe().size();
+        case Call::AssembleMeal:
+            return (e.variant == 0 ? static_cast<const MealFactory &>(veg) : nonVeg).assemble().size();
+        case Call::BuildSandwich:
+        {
+            // Only the steps the caller made are repeated
+            if (e.variant & 1)
+                sandwiches.addBread(std::string(e.fields[0]));
+            if (e.variant & 2)
+                sandwiches.addFilling(std::string(e.fields[1]));
+            if (e.variant & 4)
+                sandwiches.addSauce(std::string(e.fields[2]));
+            if (e.variant & 8)
+                sandwiches.addExtras(std::string(e.fields[3]));
+            return sandwiches.build()->describe().size();
+        }
+        case Call::Login:
+        {
+            std::uint16_t len = 0;
+            std::memcpy(&len, e.fields[1].data(), std::min(sizeof(len), e.fields[1].size()));
+            return google.login(std::string(e.fields[0]), std::string(len, '*'));
+        }
+        default:
+            return 0;
+        }
+    }
+};
+
+enum class ReplaySpeed
+{
+    Original,
+    Maximum
+};
+
+// Replays `events` on `threads` threads (events dealt round-robin). At original
+// speed each thread waits until an event's recorded offset before issuing it.
+void replay(const std::vector<TraceEvent> &events, ReplaySpeed speed, int threads)
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::array<LatencyHistogram, std::size_t(Call::Count)>> perThread(threads);
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            Services services;
+            std::size_t local = 0;
+            for (std::size_t i = t; i < events.size(); i += threads)
+            {
+                if (speed == ReplaySpeed::Original)
+                {
+                    // Sleep only when well ahead of schedule; otherwise issue immediately
+                    auto due = start + std::chrono::nanoseconds(events[i].ns - events.front().ns);
+                    if (due - Clock::now() > std::chrono::microseconds(100))
+                        std::this_thread::sleep_until(due);
+                }
+                auto begin = Clock::now();
+                local += services.drive(events[i]);
+                perThread[t][std::size_t(events[i].call)].add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+            }
+            workSink += local;
+        });
+    for (auto &w : workers)
+        w.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << (speed == ReplaySpeed::Original ? "original speed" : "maximum speed") << ", " << threads
+              << " thread(s): " << events.size() << " calls in " << std::size_t(seconds * 1000) << " ms\n";
+    for (std::size_t c = 0; c < std::size_t(Call::Count); ++c)
+    {
+        LatencyHistogram merged;
+        for (const auto &h : perThread)
+            merged.merge(h[c]);
+        std::cout << "  " << callName(Call(c)) << ": " << merged.total << " calls, p50 <= "
+                  << merged.quantile(0.5) << " ns, p99 <= " << merged.quantile(0.99) << " ns\n";
+    }
+}
+
+// A mixed workload written only against the interfaces, so it runs with or
+// without recording. When `out` is set each result is printed the way the other
+// examples print (one line, std::endl).
+std::size_t runWorkload(const OrderCreator &delivery, const OrderCreator &dineIn, const MealFactory &veg,
+                        const MealFactory &nonVeg, SandwichBuilder &builder, IAuthProvider &auth, int calls,
+                        std::ostream *out = nullptr)
+{
+    std::size_t work = 0;
+    for (int i = 0; i < calls; ++i)
+    {
+        std::string text;
+        switch (i % 4)
+        {
+        case 0:
+            text = (i % 8 ? delivery : dineIn).createOrder()->describe();
+            break;
+        case 1:
+            text = (i % 8 == 1 ? veg : nonVeg).assemble();
+            break;
+        case 2:
+            text = builder.addBread("Wheat").addFilling("Paneer").addSauce("Mint").addExtras("Lettuce,Olives").build()->describe();
+            break;
+        default:
+            text = auth.login("alice@gmail.com", "password123") ? "Signed in" : "Rejected";
+        }
+        work += text.size();
+        if (out)
+            *out << text << std::endl;
+    }
+    return work;
+}
+
+template <typename F>
+double secondsFor(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Median ns/call of `plain(calls)` and `recorded(calls)` over kOverheadRuns runs
+// each, after one warm-up. The two alternate in short runs, so drift in clock
+// speed or scheduling affects both sides alike.
+const int kOverheadRuns = 21;
+
+template <typename Plain, typename Recorded>
+std::pair<double, double> medianCostPerCall(int calls, Plain plain, Recorded recorded)
+{
+    std::vector<double> plainNs, recordedNs;
+    plain(calls);
+    recorded(calls);
+    for (int run = 0; run < kOverheadRuns; ++run)
+    {
+        // Swap which side goes first, so neither always runs on a warmer cache
+        double plainSeconds, recordedSeconds;
+        if (run % 2)
+        {
+            recordedSeconds = secondsFor([&] { recorded(calls); });
+            plainSeconds = secondsFor([&] { plain(calls); });
+        }
+        else
+        {
+            plainSeconds = secondsFor([&] { plain(calls); });
+            recordedSeconds = secondsFor([&] { recorded(calls); });
+        }
+        plainNs.push_back(plainSeconds / calls * 1e9);
+        recordedNs.push_back(recordedSeconds / calls * 1e9);
+    }
+    auto median = [](std::vector<double> v) {
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+    };
+    return {median(plainNs), median(recordedNs)};
+}
+
+// Mixed workload through plain services and through recording decorators
+std::pair<double, double> workloadCostPerCall(Services &plain, int calls, std::ostream *out)
+{
+    TraceRecorder recorder;
+    RecordingOrderCreator delivery(plain.delivery, recorder), dineIn(plain.dineIn, recorder);
+    RecordingMealFactory veg(plain.veg, recorder), nonVeg(plain.nonVeg, recorder);
+    RecordingSandwichBuilder builder(plain.sandwiches, recorder);
+    RecordingAuthProvider auth(plain.google, recorder);
+    return medianCostPerCall(
+        calls,
+        [&](int n) { workSink += runWorkload(plain.delivery, plain.dineIn, plain.veg, plain.nonVeg, plain.sandwiches, plain.google, n, out); },
+        [&](int n) { workSink += runWorkload(delivery, dineIn, veg, nonVeg, builder, auth, n, out); });
+}
+
+// Repeated logins through `auth`
+auto loginLoop(IAuthProvider &auth)
+{
+    return [&auth](int n) {
+        for (int i = 0; i < n; ++i)
+            workSink += auth.login("alice@gmail.com", "password123");
+    };
+}
+
+// What recording adds to one login: measured on the in-process provider, where
+// the difference is well above run-to-run noise
+std::pair<double, double> loginCostPerCall(IAuthProvider &auth, int calls)
+{
+    TraceRecorder recorder;
+    RecordingAuthProvider recorded(auth, recorder);
+    return medianCostPerCall(calls, loginLoop(auth), loginLoop(recorded));
+}
+
+void printOverhead(const char *label, std::pair<double, double> cost)
+{
+    double percent = (cost.second - cost.first) / cost.first * 100;
+    std::cout << "  " << label << ": " << std::size_t(cost.first) << " -> " << std::size_t(cost.second)
+              << " ns/call (" << (percent >= 0 ? "+" : "") << std::fixed << std::setprecision(1) << percent
+              << std::defaultfloat << "%)\n";
+}
+
+// With no arguments: measures recording overhead, records a workload, saves it
+// to decorator_trace.bin and replays it from the file. With a path: replays that trace.
+int main(int argc, char **argv)
+{
+    std::string trace;
+    try
+    {
+        if (argc > 1)
+        {
+            trace = loadTrace(argv[1]);
+            std::cout << "Loaded " << argv[1] << "\n";
+        }
+        else
+        {
+            Services plain;
+            // The trimmed services do well under 100 ns of work per call, so their
+            // figures are a worst case. A login that crosses a socket is the kind of
+            // call the recorder is meant for. Its round trip varies by more than the
+            // recording cost from run to run, so the cost measured on the in-process
+            // login is added to the median socket login instead of diffing two noisy
+            // socket runs.
+            std::cout << "Recording overhead (median of " << kOverheadRuns << " runs):\n";
+            printOverhead("trimmed services      ", workloadCostPerCall(plain, 20000, nullptr));
+            std::ofstream devNull("/dev/null");
+            printOverhead("same, results printed ", workloadCostPerCall(plain, 10000, &devNull));
+            auto local = loginCostPerCall(plain.google, 20000);
+            printOverhead("in-process login      ", local);
+            SocketAuthProvider remote;
+            double socketNs = medianCostPerCall(2000, loginLoop(remote), loginLoop(remote)).first;
+            printOverhead("socket-backed login   ", {socketNs, socketNs + (local.second - local.first)});
+
+            const int kCalls = 400000;
+            TraceRecorder recorder;
+            RecordingOrderCreator delivery(plain.delivery, recorder), dineIn(plain.dineIn, recorder);
+            RecordingMealFactory veg(plain.veg, recorder), nonVeg(plain.nonVeg, recorder);
+            RecordingSandwichBuilder builder(plain.sandwiches, recorder);
+            RecordingAuthProvider auth(plain.google, recorder);
+            workSink += runWorkload(delivery, dineIn, veg, nonVeg, builder, auth, kCalls);
+            std::string recorded = recorder.finish();
+
+            const std::string path = "decorator_trace.bin";
+            saveTrace(path, recorded);
+            trace = loadTrace(path);
+            if (trace != recorded)
+                throw std::runtime_error("trace changed on the way through " + path);
+            std::cout << "Recorded " << kCalls << " calls into " << path << " (" << trace.size() / 1024
+                      << " KiB); replay it later with: " << argv[0] << " " << path << "\n";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<TraceEvent> events;
+    try
+    {
+        events = parseTrace(trace);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+    if (events.empty())
+    {
+        std::cerr << "error: the trace has no calls\n";
+        return 1;
+    }
+    std::vector<TraceEvent> firstMillis; // original-speed replay of the first ~20 ms only
+    for (const auto &e : events)
+        if (e.ns - events.front().ns < 20'000'000)
+            firstMillis.push_back(e);
+
+    replay(firstMillis, ReplaySpeed::Original, 1);
+    replay(events, ReplaySpeed::Maximum, 1);
+    replay(events, ReplaySpeed::Maximum, 4);
+    return 0;
+}
+
+/*
+Output (timings vary by machine):
+Recording overhead (median of 21 runs):
+  trimmed services      : 88 -> 126 ns/call (+43.2%)
+  same, results printed : 263 -> 316 ns/call (+19.9%)
+  in-process login      : 44 -> 86 ns/call (+95.3%)
+  socket-backed login   : 4009 -> 4051 ns/call (+1.1%)
+Recorded 400000 calls into decorator_trace.bin (9960 KiB); replay it later with: ./decorator_recording_decorators_trace_record_and_replay decorator_trace.bin
+original speed, 1 thread(s): 136536 calls in 27 ms
+  placeOrder: 34134 calls, p50 <= 79 ns, p99 <= 103 ns
+  assembleMeal: 34134 calls, p50 <= 59 ns, p99 <= 87 ns
+  buildSandwich: 34134 calls, p50 <= 287 ns, p99 <= 511 ns
+  login: 34134 calls, p50 <= 95 ns, p99 <= 159 ns
+maximum speed, 1 thread(s): 400000 calls in 64 ms
+  placeOrder: 100000 calls, p50 <= 79 ns, p99 <= 111 ns
+  assembleMeal: 100000 calls, p50 <= 51 ns, p99 <= 87 ns
+  buildSandwich: 100000 calls, p50 <= 255 ns, p99 <= 447 ns
+  login: 100000 calls, p50 <= 79 ns, p99 <= 143 ns
+maximum speed, 4 thread(s): 400000 calls in 64 ms
+  ...
+*/
+// Recording needs no change to client code: wrap the services in recording decorators and pass those instead.
@@ -0,0 +1,26 @@
+// Violation: assembleMeal(string) picks products inline. Compliant: assembleMeal(factory).
+#include "bench_support.h"
+
+#include "abstract_factory/abstract_factory_compliant_example.h"
+#include "abstract_factory/violation_example.h"
+
+static void BM_AbstractFactory_Violation(benchmark::State &state)
+{
+    using namespace abstract_factory::violation_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+        assembleMeal("veg");
+}
+BENCHMARK(BM_AbstractFactory_Violation);
+
+static void BM_AbstractFactory_Compliant(benchmark::State &state)
+{
+    using namespace abstract_factory::abstract_factory_compliant_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    VegMealFactory factory;
+    for (auto _ : state)
+        assembleMeal(factory);
+}
+BENCHMARK(BM_AbstractFactory_Compliant);
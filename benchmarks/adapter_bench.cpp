@@ -0,0 +1,26 @@
+// Violation: authenticateUser() cannot reach the provider. Compliant: login through GoogleAdapter.
+#include "bench_support.h"
+
+#include "adapter/adapter_pattern_compliant_example.h"
+#include "adapter/violation_example.h"
+
+static void BM_Adapter_Violation(benchmark::State &state)
+{
+    using namespace adapter::violation_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+        authenticateUser("alice@gmail.com", "password123");
+}
+BENCHMARK(BM_Adapter_Violation);
+
+static void BM_Adapter_Compliant(benchmark::State &state)
+{
+    using namespace adapter::adapter_pattern_compliant_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    GoogleAdapter googleAuth;
+    for (auto _ : state)
+        authenticateUser(googleAuth, "alice@gmail.com", "password123");
+}
+BENCHMARK(BM_Adapter_Compliant);
@@ -0,0 +1,43 @@
+// Shared helpers for the pattern benchmarks.
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+
+// Number of operator new calls so far (operator new is replaced in bench_support.cpp)
+std::uint64_t allocationCount();
+
+// Reports allocations per iteration as the "allocs/op" counter when the benchmark ends
+class AllocationsPerOp
+{
+    benchmark::State &state;
+    std::uint64_t start;
+
+public:
+    explicit AllocationsPerOp(benchmark::State &state) : state(state), start(allocationCount()) {}
+    ~AllocationsPerOp()
+    {
+        state.counters["allocs/op"] =
+            benchmark::Counter(double(allocationCount() - start), benchmark::Counter::kAvgIterations);
+    }
+};
+
+// Discards everything written to std::cout while in scope. Formatting still
+// happens, so examples that print are measured without terminal I/O.
+class SilencedCout
+{
+    struct NullBuffer : std::streambuf
+    {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+    NullBuffer nullBuffer;
+    std::streambuf *previous;
+
+public:
+    SilencedCout() : previous(std::cout.rdbuf(&nullBuffer)) {}
+    ~SilencedCout() { std::cout.rdbuf(previous); }
+};
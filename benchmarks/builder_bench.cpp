@@ -0,0 +1,34 @@
+// Violation: the four-argument constructor. Compliant: the fluent builder.
+#include "bench_support.h"
+
+#include "builder/builder_pattern_compliant_example.h"
+#include "builder/violation_example.h"
+
+static void BM_Builder_Violation(benchmark::State &state)
+{
+    using namespace builder::violation_example;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+    {
+        Sandwich sandwich("Wheat", "Paneer", "Mint", "Lettuce,Olives");
+        benchmark::DoNotOptimize(sandwich);
+    }
+}
+BENCHMARK(BM_Builder_Violation);
+
+static void BM_Builder_Compliant(benchmark::State &state)
+{
+    using namespace builder::builder_pattern_compliant_example;
+    AllocationsPerOp allocs(state);
+    VegSandwichBuilder builder;
+    for (auto _ : state)
+    {
+        auto sandwich = builder.addBread("Wheat")
+                            .addFilling("Paneer")
+                            .addSauce("Mint")
+                            .addExtras("Lettuce,Olives")
+                            .build();
+        benchmark::DoNotOptimize(sandwich.get());
+    }
+}
+BENCHMARK(BM_Builder_Compliant);
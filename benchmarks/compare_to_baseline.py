@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Compares Google Benchmark JSON results with a recorded baseline.
+
+Every <name>.json in the baseline directory is matched with the file of the
+same name in the results directory. Both must come from repeated runs
+(--benchmark_repetitions with aggregates), and the medians are compared.
+A benchmark is slower when its median real time grows by more than the larger
+of --threshold and --noise-sigmas times the combined coefficient of variation
+of the two runs (and by more than --min-ns). It has more allocations when its
+median allocs/op counter grows by more than 0.01.
+Exits with status 1 if anything regressed.
+"""
+
+import argparse
+import json
+import math
+import os
+import sys
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    runs = {}
+    for b in data.get("benchmarks", []):
+        if b.get("run_type") != "aggregate":
+            continue
+        run = runs.setdefault(b["run_name"], {})
+        aggregate = b.get("aggregate_name")
+        if aggregate == "median":
+            run["ns"] = b["real_time"] * TO_NS[b.get("time_unit", "ns")]
+            run["allocs"] = b.get("allocs/op")
+        elif aggregate == "cv":
+            run["cv"] = b["real_time"]
+    return {name: run for name, run in runs.items() if "ns" in run}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline_dir")
+    parser.add_argument("results_dir")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("--noise-sigmas", type=float, default=3.0)
+    parser.add_argument("--min-ns", type=float, default=1.0)
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.baseline_dir):
+        print(f"No baseline in {args.baseline_dir}; run the bench_baseline target first")
+        return 1
+
+    regressions = 0
+    for file_name in sorted(os.listdir(args.baseline_dir)):
+        if not file_name.endswith(".json"):
+            continue
+        current_path = os.path.join(args.results_dir, file_name)
+        if not os.path.exists(current_path):
+            print(f"{file_name}: missing from results")
+            regressions += 1
+            continue
+        baseline, current = load(os.path.join(args.baseline_dir, file_name)), load(current_path)
+        if not baseline:
+            print(f"{file_name}: baseline has no median aggregates; re-record it with bench_baseline")
+            regressions += 1
+            continue
+        for name, base in baseline.items():
+            now = current.get(name)
+            if now is None:
+                print(f"{name}: missing from results")
+                regressions += 1
+                continue
+            change = now["ns"] / base["ns"] - 1 if base["ns"] else 0.0
+            noise = math.hypot(base.get("cv", 0.0), now.get("cv", 0.0))
+            allowed = max(args.threshold, args.noise_sigmas * noise)
+            flags = []
+            if change > allowed and now["ns"] - base["ns"] > args.min_ns:
+                flags.append("SLOWER")
+            if base["allocs"] is not None and now["allocs"] is not None and now["allocs"] > base["allocs"] + 0.01:
+                flags.append("MORE ALLOCATIONS")
+            regressions += bool(flags)
+            allocs = "" if now["allocs"] is None else f", {now['allocs']:.1f} allocs/op"
+            print(f"{name}: median {base['ns']:.1f} -> {now['ns']:.1f} ns ({change:+.1%}, allowed +{allowed:.1%}){allocs}"
+                  + (f"  <-- {', '.join(flags)}" if flags else ""))
+
+    print(f"{regressions} regression(s)")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,31 @@
+// Violation: a TaggedPost subclass. Compliant: BasicPost wrapped in a TagDecorator.
+// Both versions live in the same example section.
+#include "bench_support.h"
+
+#include "decorator/decorator_pattern_proper.h"
+
+static void BM_Decorator_Violation(benchmark::State &state)
+{
+    using namespace decorator::decorator_pattern_proper;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+    {
+        Post *post = new TaggedPost();
+        benchmark::DoNotOptimize(post->getContent());
+        delete post;
+    }
+}
+BENCHMARK(BM_Decorator_Violation);
+
+static void BM_Decorator_Compliant(benchmark::State &state)
+{
+    using namespace decorator::decorator_pattern_proper;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+    {
+        Post *post = new TagDecorator(new BasicPost());
+        benchmark::DoNotOptimize(post->getContent());
+        delete post;
+    }
+}
+BENCHMARK(BM_Decorator_Compliant);
@@ -0,0 +1,30 @@
+// Violation: createOrder(string) with if/else. Compliant: placeOrder(creator).
+#include "bench_support.h"
+
+#include "factory_method/factory_method_compliant_example.h"
+#include "factory_method/violation_example.h"
+
+static void BM_FactoryMethod_Violation(benchmark::State &state)
+{
+    using namespace factory_method::violation_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+    {
+        auto order = createOrder("delivery");
+        if (order)
+            order->describe();
+    }
+}
+BENCHMARK(BM_FactoryMethod_Violation);
+
+static void BM_FactoryMethod_Compliant(benchmark::State &state)
+{
+    using namespace factory_method::factory_method_compliant_example;
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    DeliveryOrderCreator creator;
+    for (auto _ : state)
+        placeOrder(creator);
+}
+BENCHMARK(BM_FactoryMethod_Compliant);
@@ -0,0 +1,14 @@
+// Configure-time probe (see CMakeLists.txt): run with
+// --benchmark_perf_counters=INSTRUCTIONS, its JSON output has an
+// "INSTRUCTIONS" field only when the benchmark library was built with
+// libpfm and the kernel lets this process read the counter.
+#include <benchmark/benchmark.h>
+
+static void BM_Probe(benchmark::State &state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(state.iterations());
+}
+BENCHMARK(BM_Probe)->Iterations(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,15 @@
+# Runs each benchmark executable and writes <name>.json into OUTPUT_DIR.
+# Usage: cmake -DBENCHMARKS=<exe,...> -DOUTPUT_DIR=<dir> [-DEXTRA_ARGS=<arg,...>] -P run_benchmarks.cmake
+
+string(REPLACE "," ";" BENCHMARKS "${BENCHMARKS}")
+string(REPLACE "," ";" EXTRA_ARGS "${EXTRA_ARGS}")
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+foreach(bench IN LISTS BENCHMARKS)
+    get_filename_component(name "${bench}" NAME_WE)
+    execute_process(
+        COMMAND "${bench}" "--benchmark_out=${OUTPUT_DIR}/${name}.json" --benchmark_out_format=json ${EXTRA_ARGS}
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${name} failed (${result})")
+    endif()
+endforeach()
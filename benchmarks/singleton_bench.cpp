@@ -0,0 +1,42 @@
+// Violation: a fresh generator per caller. Compliant: the shared instance.
+// InstrumentedLogin: the hot-path metrics registry used from another program.
+#include "bench_support.h"
+
+#include "singleton/singleton_compliant_example.h"
+#include "singleton/singleton_use_case_hot_path_instrumentation.h"
+#include "singleton/violation_example.h"
+
+static void BM_Singleton_Violation(benchmark::State &state)
+{
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+    {
+        singleton::violation_example::OrderNumberGenerator generator;
+        benchmark::DoNotOptimize(generator.nextOrderNumber());
+    }
+}
+BENCHMARK(BM_Singleton_Violation);
+
+static void BM_Singleton_Compliant(benchmark::State &state)
+{
+    SilencedCout quiet; // the instance announces itself on first use
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(singleton::singleton_compliant_example::OrderNumberGeneratorSingleton::getInstance().nextOrderNumber());
+}
+BENCHMARK(BM_Singleton_Compliant);
+
+// The metrics registry linked into another program: the Adapter example's
+// login, instrumented, with allocations counted by this suite's operator new
+static void BM_Singleton_InstrumentedLogin(benchmark::State &state)
+{
+    namespace hot = singleton::singleton_use_case_hot_path_instrumentation;
+    hot::Metrics::getInstance().setAllocationCounter(allocationCount);
+    hot::ad::GoogleAdapter google;
+    hot::InstrumentedAuthProvider auth(google);
+    SilencedCout quiet;
+    AllocationsPerOp allocs(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(auth.login("alice@gmail.com", "password123"));
+}
+BENCHMARK(BM_Singleton_InstrumentedLogin);
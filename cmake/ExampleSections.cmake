@@ -0,0 +1,173 @@
+# Builds the pattern examples without changing how they read.
+#
+# Every code_example.cpp holds several complete programs one after another,
+# each starting with a "// ===== Title =====" header line. dp_add_example()
+# splits a file at those headers at configure time and, for each section:
+#   - adds an executable <pattern>_<title> from the section as written, and
+#   - writes <pattern>/<title>.h, the same code wrapped in
+#     namespace <pattern>::<title> (with its #includes hoisted out), so
+#     benchmarks can link the violation and compliant versions side by side.
+#     The header defines DP_EXAMPLE_AS_LIBRARY while it is being read; code
+#     that may only appear once per program at global scope (e.g. a replaced
+#     operator new) sits inside #ifndef DP_EXAMPLE_AS_LIBRARY and is left out.
+#     The macro is undefined again at the end, so a section that includes
+#     another section's header keeps its own program-only code. Namespace-scope
+#     functions and variables are marked inline in the header, so it can be
+#     included from any number of translation units.
+#   - registers the executable as a CTest test, so its assert() checks run.
+#   - links every generated header into dp_<pattern>_header_check from two
+#     translation units, so a header that no longer builds, or that defines
+#     something twice, fails the normal build.
+# A section without its own main() is merged into the section that follows it.
+# The per-pattern INTERFACE library dp_<pattern> exposes the generated headers.
+
+set(DP_SECTIONS_DIR "${CMAKE_BINARY_DIR}/dp_sections")
+
+# "Abstract Factory-Compliant Example" -> "abstract_factory_compliant_example"
+function(_dp_slug title out_var)
+    string(TOLOWER "${title}" slug)
+    string(REGEX REPLACE "[^a-z0-9]+" "_" slug "${slug}")
+    string(REGEX REPLACE "^_+|_+$" "" slug "${slug}")
+    set(${out_var} "${slug}" PARENT_SCOPE)
+endfunction()
+
+# Writes only when the content changed, so unchanged sections don't rebuild
+function(_dp_write_if_changed path content)
+    if(EXISTS "${path}")
+        file(READ "${path}" existing)
+        if(existing STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+function(_dp_add_section pattern title text out_check)
+    _dp_slug("${title}" slug)
+    set(dir "${DP_SECTIONS_DIR}/${pattern}")
+
+    _dp_write_if_changed("${dir}/${slug}.cpp" "${text}")
+    # "adapter_pattern_compliant_example" rather than "adapter_adapter_pattern_..."
+    if(slug MATCHES "^${pattern}_")
+        set(target "${slug}")
+    else()
+        set(target "${pattern}_${slug}")
+    endif()
+    add_executable(${target} "${dir}/${slug}.cpp")
+    # Sections may include another pattern's generated header, e.g. the output sink
+    target_include_directories(${target} PRIVATE "${DP_SECTIONS_DIR}")
+    target_link_libraries(${target} PRIVATE Threads::Threads)
+    set_target_properties(${target} PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/examples/${pattern}")
+    # Examples write files into the current directory; one directory each keeps
+    # parallel test runs apart
+    set(run_dir "${CMAKE_BINARY_DIR}/example_runs/${target}")
+    file(MAKE_DIRECTORY "${run_dir}")
+    add_test(NAME ${target} COMMAND ${target} WORKING_DIRECTORY "${run_dir}")
+
+    # Conditional include blocks (#if ... #include ... #endif) move out whole,
+    # so the condition still guards them; plain includes move out one by one
+    set(include_block "#if[^\n]*\n(#include <[^>\n]+>\n)+#endif[^\n]*\n")
+    string(REGEX MATCHALL "${include_block}" blocks "${text}")
+    string(REGEX REPLACE "${include_block}" "" body "${text}")
+    string(REGEX MATCHALL "#include <[^>\n]+>" includes "${body}")
+    list(REMOVE_DUPLICATES includes)
+    string(REPLACE ";" "\n" includes "${includes}")
+    string(REPLACE ";" "" blocks "${blocks}")
+    string(REGEX REPLACE "#include <[^>\n]+>" "" body "${body}")
+    _dp_inline_definitions("${body}" body)
+    # Only the outermost generated header defines and later undefines the macro
+    string(TOUPPER "DP_EXAMPLE_AS_LIBRARY_SET_BY_${pattern}_${slug}" owner)
+    _dp_write_if_changed("${dir}/${slug}.h"
+        "// Generated from ${title} by cmake/ExampleSections.cmake. Do not edit.\n#pragma once\n#ifndef DP_EXAMPLE_AS_LIBRARY\n#define DP_EXAMPLE_AS_LIBRARY\n#define ${owner}\n#endif\n${includes}\n${blocks}\nnamespace ${pattern}::${slug}\n{\n${body}\n} // namespace ${pattern}::${slug}\n#ifdef ${owner}\n#undef DP_EXAMPLE_AS_LIBRARY\n#undef ${owner}\n#endif\n")
+
+    _dp_write_if_changed("${dir}/${slug}.check.cpp" "#include \"${pattern}/${slug}.h\"\n")
+    set(${out_check} "${dir}/${slug}.check.cpp" PARENT_SCOPE)
+endfunction()
+
+# Marks every definition that starts in column 0 (functions, out-of-class
+# members, globals) inline. Declarations that can't or needn't be inline are
+# left alone, and "/* Output: ... */" blocks are copied unchanged.
+function(_dp_inline_definitions code out_var)
+    set(result "")
+    while(NOT code STREQUAL "")
+        string(FIND "${code}" "/*" open)
+        if(open EQUAL -1)
+            set(part "${code}")
+            set(comment "")
+            set(code "")
+        else()
+            string(SUBSTRING "${code}" 0 ${open} part)
+            string(SUBSTRING "${code}" ${open} -1 code)
+            string(FIND "${code}" "*/" close)
+            if(close EQUAL -1)
+                set(comment "${code}")
+                set(code "")
+            else()
+                math(EXPR close "${close} + 2")
+                string(SUBSTRING "${code}" 0 ${close} comment)
+                string(SUBSTRING "${code}" ${close} -1 code)
+            endif()
+        endif()
+        string(REGEX REPLACE "\n([A-Za-z_])" "\ninline \\1" part "${part}")
+        string(REGEX REPLACE
+            "\ninline ((class|struct|union|enum|namespace|using|template|typedef|inline|static|extern|public|private|protected)[^A-Za-z0-9_])"
+            "\n\\1" part "${part}")
+        string(APPEND result "${part}${comment}")
+    endwhile()
+    set(${out_var} "${result}" PARENT_SCOPE)
+endfunction()
+
+# dp_add_example(<pattern> <source>)
+function(dp_add_example pattern source)
+    get_filename_component(source "${source}" ABSOLUTE)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${source}")
+    file(READ "${source}" content)
+
+    string(REGEX MATCHALL "// =====+ [^\n]* =====+" headers "${content}")
+    set(positions "")
+    foreach(header IN LISTS headers)
+        string(FIND "${content}" "${header}" pos)
+        list(APPEND positions ${pos})
+    endforeach()
+    string(LENGTH "${content}" length)
+    list(APPEND positions ${length})
+
+    list(LENGTH headers count)
+    math(EXPR last "${count} - 1")
+    set(pending "")
+    set(checks "")
+    foreach(i RANGE ${last})
+        math(EXPR next "${i} + 1")
+        list(GET positions ${i} begin)
+        list(GET positions ${next} end)
+        math(EXPR size "${end} - ${begin}")
+        string(SUBSTRING "${content}" ${begin} ${size} text)
+        list(GET headers ${i} header)
+        string(REGEX REPLACE "^// =+ (.*) =+$" "\\1" title "${header}")
+
+        set(pending "${pending}${text}")
+        if(pending MATCHES "int main\\(")
+            _dp_add_section(${pattern} "${title}" "${pending}" check)
+            list(APPEND checks "${check}")
+            set(pending "")
+        endif()
+    endforeach()
+
+    add_library(dp_${pattern} INTERFACE)
+    target_include_directories(dp_${pattern} INTERFACE "${DP_SECTIONS_DIR}")
+    target_link_libraries(dp_${pattern} INTERFACE Threads::Threads)
+
+    # One translation unit per header plus one that includes them all: a
+    # non-inline definition in any header shows up as a multiple-definition
+    # link error
+    set(all "")
+    foreach(check IN LISTS checks)
+        file(READ "${check}" include)
+        string(APPEND all "${include}")
+    endforeach()
+    set(main "${DP_SECTIONS_DIR}/${pattern}/all_headers.check.cpp")
+    _dp_write_if_changed("${main}" "${all}\nint main()\n{\n    return 0;\n}\n")
+    add_executable(dp_${pattern}_header_check ${checks} "${main}")
+    target_link_libraries(dp_${pattern}_header_check PRIVATE dp_${pattern})
+    add_test(NAME dp_${pattern}_header_check COMMAND dp_${pattern}_header_check)
+endfunction()